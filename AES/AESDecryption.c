@@ -1,4 +1,6 @@
 #include "AESDecryption.h"
+#include "aes_engine.h"
+#include "crypto/thread.h"
 
 //使用逆S盒对状态矩阵进行字节替代
 void inv_sub_bytes(byte state[4][4])
@@ -38,58 +40,49 @@ void inv_shift_rows(byte state[4][4])
 
 
 // 逆列混合操作
+// InvMixColumns 矩阵 [0e 0b 0d 09] 可分解为 MixColumns 乘上预处理 P（每列 a_r ^= 4·(a_r ^ a_{r+2})），
+// 每个字节只需要几次 xtime，而不是四次 GF(2^8) 乘法
 void inv_mix_columns(byte state[4][4])
 {
-    byte temp[4][4];
-    int i, j;
-
-    for (i = 0; i < 4; i++)
-    {
-        for (j = 0; j < 4; j++)
-        {
-            temp[i][j] = state[i][j];
-        }
-    }
-
-    for (j = 0; j < 4; j++)
+    for (int j = 0; j < 4; j++)
     {
-        state[0][j] = (byte)(mul_by_0e(temp[0][j]) ^ mul_by_0b(temp[1][j]) ^ mul_by_0d(temp[2][j]) ^ mul_by_09(temp[3][j]));
-        state[1][j] = (byte)(mul_by_09(temp[0][j]) ^ mul_by_0e(temp[1][j]) ^ mul_by_0b(temp[2][j]) ^ mul_by_0d(temp[3][j]));
-        state[2][j] = (byte)(mul_by_0d(temp[0][j]) ^ mul_by_09(temp[1][j]) ^ mul_by_0e(temp[2][j]) ^ mul_by_0b(temp[3][j]));
-        state[3][j] = (byte)(mul_by_0b(temp[0][j]) ^ mul_by_0d(temp[1][j]) ^ mul_by_09(temp[2][j]) ^ mul_by_0e(temp[3][j]));
+        byte u = xtime(xtime(state[0][j] ^ state[2][j]));
+        byte v = xtime(xtime(state[1][j] ^ state[3][j]));
+        byte a0 = state[0][j] ^ u, a1 = state[1][j] ^ v, a2 = state[2][j] ^ u, a3 = state[3][j] ^ v;
+        byte t = a0 ^ a1 ^ a2 ^ a3;
+        state[0][j] = a0 ^ t ^ xtime(a0 ^ a1);
+        state[1][j] = a1 ^ t ^ xtime(a1 ^ a2);
+        state[2][j] = a2 ^ t ^ xtime(a2 ^ a3);
+        state[3][j] = a3 ^ t ^ xtime(a3 ^ a0);
     }
 }
 
-//解密函数
-void decrypt(byte key[16], byte input[16], byte output[16])
+//解密函数（参考实现），使用等价逆密码：轮结构与加密相同，轮密钥为上下文中预先做过 InvMixColumns 的 decKeys
+void aes_ref_decrypt_block(const aes_key_ctx *ctx, const byte input[16], byte output[16])
 {
-    byte roundKeys[44][4];
+    byte state[4][4]; // 调用者私有的状态矩阵，保证可重入
     int round;
 
-    // 使用全局状态矩阵并初始化（common.c 中的 state）
-    init_state(input);
-
-    // 密钥扩展
-    key_expansion(key, roundKeys);
+    init_state(state, input);
 
     // 初始轮密钥加
-    add_round_key(roundKeys, Nr);
+    add_round_key(state, ctx->decKeys, 0);
 
     // 主轮
-    for (round = Nr - 1; round >= 1; round--)
+    for (round = 1; round < ctx->rounds; round++)
     {
-        inv_shift_rows(state);
         inv_sub_bytes(state);
-        add_round_key(roundKeys, round);
+        inv_shift_rows(state);
         inv_mix_columns(state);
+        add_round_key(state, ctx->decKeys, round);
     }
 
     // 最终轮
-    inv_shift_rows(state);
     inv_sub_bytes(state);
-    add_round_key(roundKeys, 0);
+    inv_shift_rows(state);
+    add_round_key(state, ctx->decKeys, ctx->rounds);
 
-    // 输出结果（从全局 state 读取）
+    // 输出结果
     for (int c = 0; c < 4; c++)
     {
         for (int r = 0; r < 4; r++)
@@ -99,35 +92,118 @@ void decrypt(byte key[16], byte input[16], byte output[16])
     }
 }
 
-// 使用CBC模式的AES解密函数
-void decrypt_cbc(byte key[16], byte iv[16], byte *input, byte *output, int length)
+// 单分组解密的兼容接口：临时扩展密钥后解密一个分组
+void decrypt(byte key[16], byte input[16], byte output[16])
+{
+    aes_key_ctx ctx;
+    aes_key_init(&ctx, key);
+    aes_decrypt_block(&ctx, input, output);
+    aes_key_clear(&ctx);
+}
+
+// 使用CBC模式的AES解密函数（密钥上下文版本）
+// 解密没有链式依赖：每次把 CBC_BATCH 个密文块交给引擎并行解密，再与前一个密文块异或
+#define CBC_BATCH 8
+// 每个线程至少处理的分组数，太小的分段线程开销大于收益
+#define CBC_SEGMENT_MIN_BLOCKS (64 * 1024)
+
+// 单线程解密连续的 nblocks 个分组，iv 为第一个分组之前的密文块（或初始IV）
+static void cbc_decrypt_range(const aes_key_ctx *ctx, const byte iv[16], const byte *input, byte *output, size_t nblocks)
 {
-    size_t block_count = length / BLOCK_SIZE;
     byte previous_block[BLOCK_SIZE];
+    byte next_previous[BLOCK_SIZE];
+    byte decrypted[CBC_BATCH * BLOCK_SIZE];
     memcpy(previous_block, iv, BLOCK_SIZE); // 初始化前一个块为IV
-    for(size_t i = 0; i < block_count; i++)
+    for (size_t i = 0; i < nblocks; )
     {
-        byte block[BLOCK_SIZE];
-        memcpy(block, input + i * BLOCK_SIZE, BLOCK_SIZE);
+        size_t n = (nblocks - i < CBC_BATCH) ? (nblocks - i) : CBC_BATCH;
+        const byte *in = input + i * BLOCK_SIZE;
+        byte *out = output + i * BLOCK_SIZE;
 
-        byte decrypted_block[BLOCK_SIZE];
-        decrypt(key, block, decrypted_block);
+        aes_decrypt_blocks(ctx, in, decrypted, n);
+        memcpy(next_previous, in + (n - 1) * BLOCK_SIZE, BLOCK_SIZE);
 
-        // 与前一个密文块（或IV）进行异或操作
-        for (int j = 0; j < BLOCK_SIZE; j++)
+        // 从后往前异或，input与output为同一缓冲区时也不会覆盖尚未使用的密文块
+        for (size_t b = n - 1; b > 0; b--)
         {
-            output[i * BLOCK_SIZE + j] = decrypted_block[j] ^ previous_block[j];
+            xor_block(out + b * BLOCK_SIZE, decrypted + b * BLOCK_SIZE, in + (b - 1) * BLOCK_SIZE);
         }
+        xor_block(out, decrypted, previous_block);
 
-        // 更新前一个块为当前密文块
-        memcpy(previous_block, block, BLOCK_SIZE);
+        // 更新前一个块为本批最后一个密文块
+        memcpy(previous_block, next_previous, BLOCK_SIZE);
+        i += n;
     }
 }
 
+// 每个线程负责的一段：起始IV在启动线程前就拷贝出来，原地解密时不会被其他线程覆盖
+struct cbc_segment {
+    const aes_key_ctx *ctx;
+    byte iv[BLOCK_SIZE];
+    const byte *input;
+    byte *output;
+    size_t nblocks;
+};
+
+static void cbc_segment_task(void *arg)
+{
+    struct cbc_segment *seg = (struct cbc_segment *)arg;
+    cbc_decrypt_range(seg->ctx, seg->iv, seg->input, seg->output, seg->nblocks);
+}
+
+int aes_cbc_decrypt_parallel(const aes_key_ctx *ctx, const byte iv[16], const byte *input, byte *output, size_t length, int threads)
+{
+    size_t block_count = length / BLOCK_SIZE;
+    if (threads <= 0) threads = crypto_cpu_count();
+    if ((size_t)threads > block_count / CBC_SEGMENT_MIN_BLOCKS) threads = (int)(block_count / CBC_SEGMENT_MIN_BLOCKS);
+    if (threads <= 1)
+    {
+        cbc_decrypt_range(ctx, iv, input, output, block_count);
+        return 1;
+    }
+
+    struct cbc_segment *segs = (struct cbc_segment *)malloc(sizeof(struct cbc_segment) * threads);
+    if (segs == NULL)
+    {
+        cbc_decrypt_range(ctx, iv, input, output, block_count);
+        return 1;
+    }
+    size_t per = block_count / threads;
+    size_t first = 0;
+    for (int t = 0; t < threads; t++)
+    {
+        size_t n = (t == threads - 1) ? block_count - first : per;
+        segs[t].ctx = ctx;
+        memcpy(segs[t].iv, first == 0 ? iv : input + (first - 1) * BLOCK_SIZE, BLOCK_SIZE);
+        segs[t].input = input + first * BLOCK_SIZE;
+        segs[t].output = output + first * BLOCK_SIZE;
+        segs[t].nblocks = n;
+        first += n;
+    }
+    crypto_run_parallel(cbc_segment_task, segs, sizeof(struct cbc_segment), threads);
+    free(segs);
+    return threads;
+}
+
+// 始终在调用线程中完成；需要多线程时由调用者显式使用 aes_cbc_decrypt_parallel
+void aes_cbc_decrypt(const aes_key_ctx *ctx, const byte iv[16], const byte *input, byte *output, size_t length)
+{
+    cbc_decrypt_range(ctx, iv, input, output, length / BLOCK_SIZE);
+}
+
+// 使用CBC模式的AES解密函数
+void decrypt_cbc(byte key[16], byte iv[16], byte *input, byte *output, int length)
+{
+    aes_key_ctx ctx;
+    aes_key_init(&ctx, key);
+    aes_cbc_decrypt(&ctx, iv, input, output, length);
+    aes_key_clear(&ctx);
+}
+
 // EtM模式解密  输入IV||Ciphertext||TAG
-int decrypt_etm(byte Ciperkey[16],byte Mackey[32], byte *input, size_t input_len, byte *output) {
+int decrypt_etm_ctx(const aes_key_ctx *ctx, byte Mackey[32], byte *input, size_t input_len, byte *output) {
     if (input_len < ETM_OVERHEAD) return -1; // 输入长度必须至少包含IV和HMAC
-    if(Ciperkey == NULL || Mackey == NULL || input == NULL) return -1;
+    if(ctx == NULL || Mackey == NULL || input == NULL) return -1;
 
     // 提取IV
     byte iv[ETM_IV_SIZE];
@@ -156,11 +232,11 @@ int decrypt_etm(byte Ciperkey[16],byte Mackey[32], byte *input, size_t input_len
         printf("Memory allocation failed\n");
         return -1;
     }
-    decrypt_cbc(Ciperkey, iv, ciphertext, decrypted_padded, ciphertext_len);
+    aes_cbc_decrypt(ctx, iv, ciphertext, decrypted_padded, ciphertext_len);
 
     // 移除填充
     int unpadded_len = pkcs7_unpad(decrypted_padded, ciphertext_len, output);
-    // free(decrypted_padded);
+    free(decrypted_padded);
     if (unpadded_len < 0) {
         printf("Invalid padding!\n");
         return -1;
@@ -169,6 +245,15 @@ int decrypt_etm(byte Ciperkey[16],byte Mackey[32], byte *input, size_t input_len
     return unpadded_len; // 返回解密后数据的长度
 }
 
+int decrypt_etm(byte Ciperkey[16],byte Mackey[32], byte *input, size_t input_len, byte *output) {
+    if (Ciperkey == NULL) return -1;
+    aes_key_ctx ctx;
+    aes_key_init(&ctx, Ciperkey);
+    int ret = decrypt_etm_ctx(&ctx, Mackey, input, input_len, output);
+    aes_key_clear(&ctx);
+    return ret;
+}
+
 
 //对文件进行AES解密
 void decrypt_file(const char *input_filename, const char *output_filename, byte key[16])
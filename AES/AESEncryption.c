@@ -1,7 +1,9 @@
 #include "AESEncryption.h"
+#include "aes_engine.h"
 #include "crypto/rng.h"
+#include <limits.h>
 // 字节替代操作
-static void SubBytes(void)
+static void SubBytes(byte state[4][4])
 {
     int i, j;
     for (i = 0; i < 4; i++)
@@ -14,7 +16,7 @@ static void SubBytes(void)
 }
 
 // 行移位操作
-static void shift_rows(void)
+static void shift_rows(byte state[4][4])
 {
     byte temp[4][4];
     int i, j;
@@ -37,7 +39,7 @@ static void shift_rows(void)
 }
 
 // 列混合
-static void MixColumns(void)
+static void MixColumns(byte state[4][4])
 {
     byte temp[4][4];
     int i, j;
@@ -59,25 +61,26 @@ static void MixColumns(void)
     }
 }
 
-// AES加密函数
-void encrypt(byte key[16], byte input[16], byte output[16]) {
-    byte roundKeys[44][4];
+// AES加密函数（参考实现），轮密钥由上下文提供，不再对每个分组重复密钥扩展
+// 作为可读的正确性基准，轮数直接取 ctx->rounds，其他引擎为每种密钥长度各展开一份
+// 状态矩阵放在调用者的栈上，多个线程可以同时加密
+void aes_ref_encrypt_block(const aes_key_ctx *ctx, const byte input[16], byte output[16]) {
+    byte state[4][4];
     int round;
     
-    init_state(input);
-    key_expansion(key, roundKeys);
-    add_round_key(roundKeys, 0);
+    init_state(state, input);
+    add_round_key(state, ctx->roundKeys, 0);
     
-    for(round = 1; round < Nr; round++) {
-        SubBytes();
-        shift_rows();
-        MixColumns();
-        add_round_key(roundKeys, round);
+    for(round = 1; round < ctx->rounds; round++) {
+        SubBytes(state);
+        shift_rows(state);
+        MixColumns(state);
+        add_round_key(state, ctx->roundKeys, round);
     }
     
-    SubBytes();
-    shift_rows();
-    add_round_key(roundKeys, Nr);
+    SubBytes(state);
+    shift_rows(state);
+    add_round_key(state, ctx->roundKeys, ctx->rounds);
     
     int c, r;
     for(c = 0; c < 4; c++) {
@@ -87,11 +90,19 @@ void encrypt(byte key[16], byte input[16], byte output[16]) {
     }
 }
 
+// 单分组加密的兼容接口：临时扩展密钥后加密一个分组
+void encrypt(byte key[16], byte input[16], byte output[16]) {
+    aes_key_ctx ctx;
+    aes_key_init(&ctx, key);
+    aes_encrypt_block(&ctx, input, output);
+    aes_key_clear(&ctx);
+}
 
 
 
-// 使用CBC模式的AES加密函数
-void encrypt_cbc(byte key[16], byte iv[16], byte *input, byte *output, int length) {
+
+// 使用CBC模式的AES加密函数（密钥上下文版本）
+void aes_cbc_encrypt(const aes_key_ctx *ctx, const byte iv[16], const byte *input, byte *output, size_t length) {
     size_t block_count = length / BLOCK_SIZE;
     byte previous_block[BLOCK_SIZE];
     memcpy(previous_block, iv, BLOCK_SIZE); // 初始化前一个块为IV
@@ -101,57 +112,205 @@ void encrypt_cbc(byte key[16], byte iv[16], byte *input, byte *output, int lengt
         for (size_t j = 0; j < BLOCK_SIZE; j++) {
             block[j] = input[i * BLOCK_SIZE + j] ^ previous_block[j];
         }
-        byte encrypted_block[BLOCK_SIZE];
-        encrypt(key, block, encrypted_block);
-        memcpy(&output[i * BLOCK_SIZE], encrypted_block, BLOCK_SIZE);
-        memcpy(previous_block, encrypted_block, BLOCK_SIZE); // 更新前一个块
+        aes_encrypt_block(ctx, block, previous_block); // 密文块即下一轮的前一个块
+        memcpy(&output[i * BLOCK_SIZE], previous_block, BLOCK_SIZE);
     }
 }
 
-//EtM模式加密   输出IV||Ciphertext||TAG
-int encrypt_etm(byte Ciperkey[16],byte Mackey[32], byte iv[16], byte *input, size_t input_len, byte *output) {
-    /* input_len is size_t (unsigned) — no need to check < 0 */
-    if (Ciperkey == NULL || Mackey == NULL || input == NULL) return -1;
-
-    // 生成随机IV
-    if(iv == NULL) {
-        iv = (byte *)malloc(ETM_IV_SIZE);
-        if(iv == NULL) {
-            printf("Memory allocation failed\n");
-            return -1;
+// 使用CBC模式的AES加密函数
+void encrypt_cbc(byte key[16], byte iv[16], byte *input, byte *output, int length) {
+    aes_key_ctx ctx;
+    aes_key_init(&ctx, key);
+    aes_cbc_encrypt(&ctx, iv, input, output, length);
+    aes_key_clear(&ctx);
+}
+
+// CTR 模式    参考NIST SP 800-38A 6.5
+// 计数器块 T_j = iv + j（128 位大端整数加法，模 2^128 回绕），输出 = 输入 ⊕ E(K, T_j)，加解密是同一个运算。
+// 计数器在两个 64 位字中递增，每次为 CTR_BATCH 个分组生成计数器块、一次交给引擎的多分组接口，
+// 再按 64 位字异或。offset 为密钥流中的字节位置，起始计数器 T_(offset/16) 直接算出，
+// 所以大对象的任意字节区间都能单独加解密，不必先处理前面的数据
+#define CTR_BATCH 32 // 512 字节的计数器与密钥流缓冲，留在 L1 中
+
+// 64 位字在主机字节序与大端之间转换；移位与掩码写法被编译器识别为一条字节交换指令
+static uint64_t ctr_swap_be64(uint64_t v)
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    return v;
+#else
+    v = ((v & 0x00ff00ff00ff00ffULL) << 8) | ((v >> 8) & 0x00ff00ff00ff00ffULL);
+    v = ((v & 0x0000ffff0000ffffULL) << 16) | ((v >> 16) & 0x0000ffff0000ffffULL);
+    return (v << 32) | (v >> 32);
+#endif
+}
+
+static uint64_t ctr_load_be64(const byte *p)
+{
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return ctr_swap_be64(v);
+}
+
+// 计数器块按两个 64 位字写入：逐字节写入每个分组要 16 次存储，比引擎加密这个分组还慢
+static void ctr_store_be64(byte *p, uint64_t v)
+{
+    v = ctr_swap_be64(v);
+    memcpy(p, &v, 8);
+}
+
+void aes_ctr_crypt(const aes_key_ctx *ctx, const byte iv[16], uint64_t offset, const byte *input, byte *output,
+                   size_t length)
+{
+    byte ctr[CTR_BATCH * BLOCK_SIZE], ks[CTR_BATCH * BLOCK_SIZE];
+    uint64_t hi = ctr_load_be64(iv), lo = ctr_load_be64(iv + 8);
+    uint64_t start = offset / BLOCK_SIZE;
+    size_t skip = (size_t)(offset % BLOCK_SIZE); // 起始分组中已经用掉的密钥流字节
+
+    lo += start;
+    if (lo < start) hi++;
+    while (length > 0) {
+        size_t n = (skip + length < sizeof(ks)) ? skip + length : sizeof(ks);
+        size_t blocks = (n + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        for (size_t b = 0; b < blocks; b++) {
+            ctr_store_be64(ctr + b * BLOCK_SIZE, hi);
+            ctr_store_be64(ctr + b * BLOCK_SIZE + 8, lo);
+            if (++lo == 0) hi++;
         }
-        crypto_random_bytes(iv, ETM_IV_SIZE);
+        aes_encrypt_blocks(ctx, ctr, ks, blocks);
+        n -= skip;
+        xor_bytes(output, input, ks + skip, n);
+        skip = 0;
+        input += n;
+        output += n;
+        length -= n;
     }
-    memcpy(output, iv, ETM_IV_SIZE); // 将IV写入输出
+    secure_zero(ks, sizeof(ks)); // 密钥流与明文同样敏感
+}
 
-    // PKCS#7填充
-    int padded_len;
-    byte *padded_input = (byte *)malloc(input_len + BLOCK_SIZE);
-    if(padded_input == NULL) {
-        printf("Memory allocation failed\n");
-        return -1;
+// 多路CBC加密：单条CBC链是串行的，把最多 AES_MAX_LANES 条独立的链交错起来，每轮同时推进每条链的一个分组
+// 每次交给引擎的步数为当前各链剩余分组数的最小值，某条链结束后由下一个任务补上空出的通道
+void aes_cbc_encrypt_multi(aes_cbc_job *jobs, size_t njobs)
+{
+    size_t lane_job[AES_MAX_LANES];
+    size_t lane_pos[AES_MAX_LANES];
+    const aes_key_ctx *ctxs[AES_MAX_LANES];
+    byte *ivs[AES_MAX_LANES];
+    const byte *in[AES_MAX_LANES];
+    byte *out[AES_MAX_LANES];
+    size_t active = 0, next = 0;
+
+    for (;;) {
+        while (active < AES_MAX_LANES && next < njobs) {
+            if (jobs[next].length >= BLOCK_SIZE) {
+                lane_job[active] = next;
+                lane_pos[active] = 0;
+                active++;
+            }
+            next++;
+        }
+        if (active == 0) break;
+
+        size_t steps = SIZE_MAX;
+        for (size_t l = 0; l < active; l++) {
+            aes_cbc_job *job = &jobs[lane_job[l]];
+            size_t left = (job->length - lane_pos[l]) / BLOCK_SIZE;
+            if (left < steps) steps = left;
+            ctxs[l] = job->ctx;
+            ivs[l] = job->iv;
+            in[l] = job->input + lane_pos[l];
+            out[l] = job->output + lane_pos[l];
+        }
+        aes_cbc_encrypt_lanes(ctxs, ivs, in, out, active, steps);
+
+        // 移除已完成的链，末尾的通道移到空位上
+        for (size_t l = 0; l < active; ) {
+            lane_pos[l] += steps * BLOCK_SIZE;
+            if (lane_pos[l] + BLOCK_SIZE > jobs[lane_job[l]].length) {
+                active--;
+                lane_job[l] = lane_job[active];
+                lane_pos[l] = lane_pos[active];
+            } else {
+                l++;
+            }
+        }
     }
-    pkcs7_pad(input, input_len, padded_input, &padded_len);
+}
 
-    // 加密数据
-    byte *encrypted_data = (byte *)malloc(padded_len);
-    if(encrypted_data == NULL) {
-        printf("Memory allocation failed\n");
-        free(padded_input);
-        return -1;
+// 批量EtM加密：先给每个任务写入IV并填充，所有CBC链交错加密，最后逐个计算HMAC
+#define ETM_BATCH_CHUNK 32
+int encrypt_etm_batch(etm_job *jobs, size_t njobs)
+{
+    aes_cbc_job cbc[ETM_BATCH_CHUNK];
+    size_t map[ETM_BATCH_CHUNK];
+    int done = 0;
+
+    for (size_t base = 0; base < njobs; base += ETM_BATCH_CHUNK) {
+        size_t count = (njobs - base < ETM_BATCH_CHUNK) ? njobs - base : ETM_BATCH_CHUNK;
+        size_t n = 0;
+        for (size_t i = base; i < base + count; i++) {
+            etm_job *job = &jobs[i];
+            job->output_len = -1;
+            if (job->ctx == NULL || job->mac_key == NULL || job->input == NULL || job->output == NULL) continue;
+            // pkcs7_pad 与 output_len 都是 int：总输出长度放不进 int 的任务直接失败
+            if (job->input_len > (size_t)INT_MAX - (ETM_IV_SIZE + BLOCK_SIZE + ETM_HMAC_SIZE)) continue;
+
+            // 未提供IV时生成随机IV
+            if (job->iv == NULL) {
+                if (crypto_random_bytes(job->output, ETM_IV_SIZE) != 0) continue;
+            } else {
+                memcpy(job->output, job->iv, ETM_IV_SIZE); // 将IV写入输出
+            }
+
+            // PKCS#7填充直接写到输出缓冲区，随后原地加密
+            int padded_len;
+            pkcs7_pad((byte *)job->input, (int)job->input_len, job->output + ETM_IV_SIZE, &padded_len);
+
+            cbc[n].ctx = job->ctx;
+            memcpy(cbc[n].iv, job->output, ETM_IV_SIZE);
+            cbc[n].input = job->output + ETM_IV_SIZE;
+            cbc[n].output = job->output + ETM_IV_SIZE;
+            cbc[n].length = (size_t)padded_len;
+            map[n++] = i;
+        }
+
+        aes_cbc_encrypt_multi(cbc, n);
+
+        // 计算HMAC（覆盖 IV||Ciphertext）
+        for (size_t k = 0; k < n; k++) {
+            etm_job *job = &jobs[map[k]];
+            size_t body = ETM_IV_SIZE + cbc[k].length;
+            hmac_sha256(job->mac_key, 32, job->output, body, job->output + body);
+            job->output_len = (int)(body + ETM_HMAC_SIZE);
+            done++;
+        }
     }
-    encrypt_cbc(Ciperkey, iv, padded_input, encrypted_data, padded_len);
-    memcpy(output + ETM_IV_SIZE, encrypted_data, padded_len);
+    return done;
+}
 
-    // 计算HMAC
-    byte hmac[ETM_HMAC_SIZE];
-    hmac_sha256(Mackey, 32, output, ETM_IV_SIZE + padded_len, hmac);
-    memcpy(output + ETM_IV_SIZE + padded_len, hmac, ETM_HMAC_SIZE);
-    // 清理
-    // free(padded_input);
-    // free(encrypted_data);
+//EtM模式加密   输出IV||Ciphertext||TAG
+int encrypt_etm_ctx(const aes_key_ctx *ctx, byte Mackey[32], byte iv[16], byte *input, size_t input_len, byte *output) {
+    /* input_len is size_t (unsigned) — no need to check < 0 */
+    if (ctx == NULL || Mackey == NULL || input == NULL) return -1;
 
-    return ETM_OVERHEAD + padded_len; // 返回总输出长度
+    // 单个任务的批量加密，与批量接口保证输出逐字节相同
+    etm_job job;
+    job.ctx = ctx;
+    job.mac_key = Mackey;
+    job.iv = iv;
+    job.input = input;
+    job.input_len = input_len;
+    job.output = output;
+    encrypt_etm_batch(&job, 1);
+    return job.output_len; // 返回总输出长度
+}
+
+int encrypt_etm(byte Ciperkey[16],byte Mackey[32], byte iv[16], byte *input, size_t input_len, byte *output) {
+    if (Ciperkey == NULL) return -1;
+    aes_key_ctx ctx;
+    aes_key_init(&ctx, Ciperkey);
+    int ret = encrypt_etm_ctx(&ctx, Mackey, iv, input, input_len, output);
+    aes_key_clear(&ctx);
+    return ret;
 }
 
 
@@ -6,6 +6,20 @@
 #include "crypto/hmac.h"
 // The function declarations are provided by crypto/aes.h.
 // Keep this file for backwards compatibility and internal includes.
+// 批量EtM加密任务：output 至少需要 input_len + BLOCK_SIZE + ETM_OVERHEAD 字节，且不能与 input 重叠
+typedef struct etm_job {
+    const aes_key_ctx *ctx;
+    const byte *mac_key;   // 32字节HMAC密钥
+    const byte *iv;        // NULL时随机生成
+    const byte *input;
+    size_t input_len;
+    byte *output;          // IV||Ciphertext||TAG
+    int output_len;        // 返回的输出长度，失败为-1（包括输出长度超过 INT_MAX）
+} etm_job;
+
+// 多个任务的CBC链交错加密（aes_cbc_encrypt_multi），结果与逐个调用 encrypt_etm_ctx 相同；返回成功的任务数
+int encrypt_etm_batch(etm_job *jobs, size_t njobs);
+int encrypt_etm_ctx(const aes_key_ctx *ctx, byte Mackey[32], byte iv[16], byte *input, size_t input_len, byte *output);
 int encrypt_etm(byte Ciperkey[16],byte Mackey[32], byte iv[16], byte *input, size_t input_len, byte *output);
 int encrypt_file_etm(const char *input_filename, const char *output_filename, byte Ciperkey[16], byte Mackey[32]);
 void encrypt(byte key[16], byte input[16], byte output[16]);
@@ -0,0 +1,408 @@
+#include "aes_engine.h"
+
+// 位切片（bitsliced）常量时间AES引擎：8个分组同时计算，全程只有与、异或、移位，没有任何按数据查表
+// 布局与 BearSSL ct64 相同：4个分组交织成8个64位字，每个字保存所有字节的同一位
+// 用 GCC 向量扩展把两个64位字放进一个128位寄存器（x86上即SSE2），一次处理两组共8个分组
+// S盒使用 Boyar-Peralta 的布尔电路，逆S盒 = 逆仿射 -> S盒 -> 逆仿射；密钥扩展的 SubWord 也走同一电路
+
+typedef uint64_t bs_word __attribute__((vector_size(16)));
+
+#define BS_BLOCKS 8 // 每次处理的分组数：2个向量通道 × 每通道4个分组
+
+// 交换 a、b 中按掩码分开的位，完成8个字之间的位矩阵转置
+#define SWAPN(cl, ch, s, x, y) do { \
+        bs_word a_ = (x), b_ = (y); \
+        (x) = (a_ & (uint64_t)(cl)) | ((b_ & (uint64_t)(cl)) << (s)); \
+        (y) = ((a_ & (uint64_t)(ch)) >> (s)) | (b_ & (uint64_t)(ch)); \
+    } while (0)
+#define SWAP2(x, y) SWAPN(0x5555555555555555, 0xAAAAAAAAAAAAAAAA, 1, x, y)
+#define SWAP4(x, y) SWAPN(0x3333333333333333, 0xCCCCCCCCCCCCCCCC, 2, x, y)
+#define SWAP8(x, y) SWAPN(0x0F0F0F0F0F0F0F0F, 0xF0F0F0F0F0F0F0F0, 4, x, y)
+
+// 正交变换：字节序布局 <-> 位切片布局，自身即为逆变换
+static void bs_ortho(bs_word q[8])
+{
+    SWAP2(q[0], q[1]); SWAP2(q[2], q[3]); SWAP2(q[4], q[5]); SWAP2(q[6], q[7]);
+    SWAP4(q[0], q[2]); SWAP4(q[1], q[3]); SWAP4(q[4], q[6]); SWAP4(q[5], q[7]);
+    SWAP8(q[0], q[4]); SWAP8(q[1], q[5]); SWAP8(q[2], q[6]); SWAP8(q[3], q[7]);
+}
+
+// 一个分组的4个小端32位字拆成两个64位字（偶数列、奇数列），4个分组在字内交织
+static void interleave_in(uint64_t *q0, uint64_t *q1, const uint32_t w[4])
+{
+    uint64_t x0 = w[0], x1 = w[1], x2 = w[2], x3 = w[3];
+    x0 |= (x0 << 16); x1 |= (x1 << 16); x2 |= (x2 << 16); x3 |= (x3 << 16);
+    x0 &= 0x0000FFFF0000FFFF; x1 &= 0x0000FFFF0000FFFF;
+    x2 &= 0x0000FFFF0000FFFF; x3 &= 0x0000FFFF0000FFFF;
+    x0 |= (x0 << 8); x1 |= (x1 << 8); x2 |= (x2 << 8); x3 |= (x3 << 8);
+    x0 &= 0x00FF00FF00FF00FF; x1 &= 0x00FF00FF00FF00FF;
+    x2 &= 0x00FF00FF00FF00FF; x3 &= 0x00FF00FF00FF00FF;
+    *q0 = x0 | (x2 << 8);
+    *q1 = x1 | (x3 << 8);
+}
+
+static void interleave_out(uint32_t w[4], uint64_t q0, uint64_t q1)
+{
+    uint64_t x0 = q0 & 0x00FF00FF00FF00FF;
+    uint64_t x1 = q1 & 0x00FF00FF00FF00FF;
+    uint64_t x2 = (q0 >> 8) & 0x00FF00FF00FF00FF;
+    uint64_t x3 = (q1 >> 8) & 0x00FF00FF00FF00FF;
+    x0 |= (x0 >> 8); x1 |= (x1 >> 8); x2 |= (x2 >> 8); x3 |= (x3 >> 8);
+    x0 &= 0x0000FFFF0000FFFF; x1 &= 0x0000FFFF0000FFFF;
+    x2 &= 0x0000FFFF0000FFFF; x3 &= 0x0000FFFF0000FFFF;
+    w[0] = (uint32_t)x0 | (uint32_t)(x0 >> 16);
+    w[1] = (uint32_t)x1 | (uint32_t)(x1 >> 16);
+    w[2] = (uint32_t)x2 | (uint32_t)(x2 >> 16);
+    w[3] = (uint32_t)x3 | (uint32_t)(x3 >> 16);
+}
+
+static uint32_t load_le32(const byte *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void store_le32(byte *p, uint32_t v)
+{
+    p[0] = (byte)v; p[1] = (byte)(v >> 8); p[2] = (byte)(v >> 16); p[3] = (byte)(v >> 24);
+}
+
+// S盒布尔电路（Boyar-Peralta，113个门），q[0]为最低位
+static void bs_sbox(bs_word q[8])
+{
+    bs_word x0, x1, x2, x3, x4, x5, x6, x7;
+    bs_word y1, y2, y3, y4, y5, y6, y7, y8, y9, y10, y11, y12, y13, y14, y15, y16, y17, y18, y19, y20, y21;
+    bs_word z0, z1, z2, z3, z4, z5, z6, z7, z8, z9, z10, z11, z12, z13, z14, z15, z16, z17;
+    bs_word t0, t1, t2, t3, t4, t5, t6, t7, t8, t9, t10, t11, t12, t13, t14, t15, t16, t17, t18, t19;
+    bs_word t20, t21, t22, t23, t24, t25, t26, t27, t28, t29, t30, t31, t32, t33, t34, t35, t36, t37, t38, t39;
+    bs_word t40, t41, t42, t43, t44, t45, t46, t47, t48, t49, t50, t51, t52, t53, t54, t55, t56, t57, t58, t59;
+    bs_word t60, t61, t62, t63, t64, t65, t66, t67;
+    bs_word s0, s1, s2, s3, s4, s5, s6, s7;
+
+    x0 = q[7]; x1 = q[6]; x2 = q[5]; x3 = q[4];
+    x4 = q[3]; x5 = q[2]; x6 = q[1]; x7 = q[0];
+
+    // 顶层线性变换
+    y14 = x3 ^ x5; y13 = x0 ^ x6; y9 = x0 ^ x3; y8 = x0 ^ x5; t0 = x1 ^ x2;
+    y1 = t0 ^ x7; y4 = y1 ^ x3; y12 = y13 ^ y14; y2 = y1 ^ x0; y5 = y1 ^ x6;
+    y3 = y5 ^ y8; t1 = x4 ^ y12; y15 = t1 ^ x5; y20 = t1 ^ x1; y6 = y15 ^ x7;
+    y10 = y15 ^ t0; y11 = y20 ^ y9; y7 = x7 ^ y11; y17 = y10 ^ y11; y19 = y10 ^ y8;
+    y16 = t0 ^ y11; y21 = y13 ^ y16; y18 = x0 ^ y16;
+
+    // GF(2^4) 上的非线性部分（求逆）
+    t2 = y12 & y15; t3 = y3 & y6; t4 = t3 ^ t2; t5 = y4 & x7; t6 = t5 ^ t2;
+    t7 = y13 & y16; t8 = y5 & y1; t9 = t8 ^ t7; t10 = y2 & y7; t11 = t10 ^ t7;
+    t12 = y9 & y11; t13 = y14 & y17; t14 = t13 ^ t12; t15 = y8 & y10; t16 = t15 ^ t12;
+    t17 = t4 ^ t14; t18 = t6 ^ t16; t19 = t9 ^ t14; t20 = t11 ^ t16; t21 = t17 ^ y20;
+    t22 = t18 ^ y19; t23 = t19 ^ y21; t24 = t20 ^ y18; t25 = t21 ^ t22; t26 = t21 & t23;
+    t27 = t24 ^ t26; t28 = t25 & t27; t29 = t28 ^ t22; t30 = t23 ^ t24; t31 = t22 ^ t26;
+    t32 = t31 & t30; t33 = t32 ^ t24; t34 = t23 ^ t33; t35 = t27 ^ t33; t36 = t24 & t35;
+    t37 = t36 ^ t34; t38 = t27 ^ t36; t39 = t29 & t38; t40 = t25 ^ t39; t41 = t40 ^ t37;
+    t42 = t29 ^ t33; t43 = t29 ^ t40; t44 = t33 ^ t37; t45 = t42 ^ t41;
+    z0 = t44 & y15; z1 = t37 & y6; z2 = t33 & x7; z3 = t43 & y16; z4 = t40 & y1;
+    z5 = t29 & y7; z6 = t42 & y11; z7 = t45 & y17; z8 = t41 & y10; z9 = t44 & y12;
+    z10 = t37 & y3; z11 = t33 & y4; z12 = t43 & y13; z13 = t40 & y5; z14 = t29 & y2;
+    z15 = t42 & y9; z16 = t45 & y14; z17 = t41 & y8;
+
+    // 底层线性变换
+    t46 = z15 ^ z16; t47 = z10 ^ z11; t48 = z5 ^ z13; t49 = z9 ^ z10; t50 = z2 ^ z12;
+    t51 = z2 ^ z5; t52 = z7 ^ z8; t53 = z0 ^ z3; t54 = z6 ^ z7; t55 = z16 ^ z17;
+    t56 = z12 ^ t48; t57 = t50 ^ t53; t58 = z4 ^ t46; t59 = z3 ^ t54; t60 = t46 ^ t57;
+    t61 = z14 ^ t57; t62 = t52 ^ t58; t63 = t49 ^ t58; t64 = z4 ^ t59; t65 = t61 ^ t62;
+    t66 = z1 ^ t63; s0 = t59 ^ t63; s6 = t56 ^ ~t62; s7 = t48 ^ ~t60;
+    t67 = t64 ^ t65; s3 = t53 ^ t66; s4 = t51 ^ t66; s5 = t47 ^ t65;
+    s1 = t64 ^ ~s3; s2 = t55 ^ ~t67;
+
+    q[7] = s0; q[6] = s1; q[5] = s2; q[4] = s3;
+    q[3] = s4; q[2] = s5; q[1] = s6; q[0] = s7;
+}
+
+// S盒仿射变换的逆（含常量0x05）：b_i = a_{i+2} ^ a_{i+5} ^ a_{i+7} ^ c_i
+static void bs_inv_affine(bs_word q[8])
+{
+    bs_word a[8];
+    for (int i = 0; i < 8; i++) a[i] = q[i];
+    for (int i = 0; i < 8; i++) q[i] = a[(i + 2) & 7] ^ a[(i + 5) & 7] ^ a[(i + 7) & 7];
+    q[0] = ~q[0];
+    q[2] = ~q[2];
+}
+
+// InvSubBytes(x) = A^-1(S(A^-1(x)))：S盒本身是 A(inv(x))，两边各抵消一次仿射
+static void bs_inv_sbox(bs_word q[8])
+{
+    bs_inv_affine(q);
+    bs_sbox(q);
+    bs_inv_affine(q);
+}
+
+static void bs_shift_rows(bs_word q[8])
+{
+    for (int i = 0; i < 8; i++) {
+        bs_word x = q[i];
+        q[i] = (x & (uint64_t)0x000000000000FFFF)
+             | ((x & (uint64_t)0x00000000FFF00000) >> 4)
+             | ((x & (uint64_t)0x00000000000F0000) << 12)
+             | ((x & (uint64_t)0x0000FF0000000000) >> 8)
+             | ((x & (uint64_t)0x000000FF00000000) << 8)
+             | ((x & (uint64_t)0xF000000000000000) >> 12)
+             | ((x & (uint64_t)0x0FFF000000000000) << 4);
+    }
+}
+
+static void bs_inv_shift_rows(bs_word q[8])
+{
+    for (int i = 0; i < 8; i++) {
+        bs_word x = q[i];
+        q[i] = (x & (uint64_t)0x000000000000FFFF)
+             | ((x & (uint64_t)0x000000000FFF0000) << 4)
+             | ((x & (uint64_t)0x00000000F0000000) >> 12)
+             | ((x & (uint64_t)0x000000FF00000000) << 8)
+             | ((x & (uint64_t)0x0000FF0000000000) >> 8)
+             | ((x & (uint64_t)0x000F000000000000) << 12)
+             | ((x & (uint64_t)0xFFF0000000000000) >> 4);
+    }
+}
+
+static bs_word rotr32(bs_word x)
+{
+    return (x << 32) | (x >> 32);
+}
+
+static bs_word rotr16(bs_word x)
+{
+    return (x >> 16) | (x << 48);
+}
+
+static void bs_mix_columns(bs_word q[8])
+{
+    bs_word q0 = q[0], q1 = q[1], q2 = q[2], q3 = q[3], q4 = q[4], q5 = q[5], q6 = q[6], q7 = q[7];
+    bs_word r0 = rotr16(q0), r1 = rotr16(q1), r2 = rotr16(q2), r3 = rotr16(q3);
+    bs_word r4 = rotr16(q4), r5 = rotr16(q5), r6 = rotr16(q6), r7 = rotr16(q7);
+
+    q[0] = q7 ^ r7 ^ r0 ^ rotr32(q0 ^ r0);
+    q[1] = q0 ^ r0 ^ q7 ^ r7 ^ r1 ^ rotr32(q1 ^ r1);
+    q[2] = q1 ^ r1 ^ r2 ^ rotr32(q2 ^ r2);
+    q[3] = q2 ^ r2 ^ q7 ^ r7 ^ r3 ^ rotr32(q3 ^ r3);
+    q[4] = q3 ^ r3 ^ q7 ^ r7 ^ r4 ^ rotr32(q4 ^ r4);
+    q[5] = q4 ^ r4 ^ r5 ^ rotr32(q5 ^ r5);
+    q[6] = q5 ^ r5 ^ r6 ^ rotr32(q6 ^ r6);
+    q[7] = q6 ^ r6 ^ r7 ^ rotr32(q7 ^ r7);
+}
+
+// InvMixColumns = MixColumns ∘ P，其中 P(a) = a ^ 04·(a ^ rotr32(a))（每列乘 {04}x^2 + {05}）
+static void bs_inv_mix_columns(bs_word q[8])
+{
+    bs_word t[8];
+    for (int i = 0; i < 8; i++) t[i] = q[i] ^ rotr32(q[i]);
+    // 位切片的 xtime 两次：{04}·t
+    q[0] ^= t[6];
+    q[1] ^= t[6] ^ t[7];
+    q[2] ^= t[0] ^ t[7];
+    q[3] ^= t[1] ^ t[6];
+    q[4] ^= t[2] ^ t[6] ^ t[7];
+    q[5] ^= t[3] ^ t[7];
+    q[6] ^= t[4];
+    q[7] ^= t[5];
+    bs_mix_columns(q);
+}
+
+static void bs_add_round_key(bs_word q[8], const uint64_t *sk)
+{
+    for (int i = 0; i < 8; i++) q[i] ^= sk[i];
+}
+
+// 8个分组读入位切片状态：通道0保存分组0-3，通道1保存分组4-7
+static void bs_load(bs_word q[8], const byte *in)
+{
+    uint64_t lo[8], hi[8];
+    for (int lane = 0; lane < 2; lane++) {
+        uint64_t *v = lane ? hi : lo;
+        for (int i = 0; i < 4; i++) {
+            const byte *p = in + (lane * 4 + i) * BLOCK_SIZE;
+            uint32_t w[4] = { load_le32(p), load_le32(p + 4), load_le32(p + 8), load_le32(p + 12) };
+            interleave_in(&v[i], &v[i + 4], w);
+        }
+    }
+    for (int i = 0; i < 8; i++) q[i] = (bs_word){ lo[i], hi[i] };
+    bs_ortho(q);
+}
+
+static void bs_store(byte *out, bs_word q[8])
+{
+    bs_ortho(q);
+    for (int lane = 0; lane < 2; lane++) {
+        for (int i = 0; i < 4; i++) {
+            byte *p = out + (lane * 4 + i) * BLOCK_SIZE;
+            uint32_t w[4];
+            interleave_out(w, q[i][lane], q[i + 4][lane]);
+            for (int j = 0; j < 4; j++) store_le32(p + 4 * j, w[j]);
+        }
+    }
+}
+
+// 轮数 nr 在每种密钥长度的实例中是常量，轮序列完全展开
+static inline __attribute__((always_inline)) void
+bs_encrypt8(const aes_key_ctx *ctx, const byte *in, byte *out, const int nr)
+{
+    const uint64_t *sk = ctx->bsKeys;
+    bs_word q[8];
+
+    bs_load(q, in);
+    bs_add_round_key(q, sk);
+#pragma GCC unroll 16
+    for (int round = 1; round < nr; round++) {
+        bs_sbox(q);
+        bs_shift_rows(q);
+        bs_mix_columns(q);
+        bs_add_round_key(q, sk + round * 8);
+    }
+    bs_sbox(q);
+    bs_shift_rows(q);
+    bs_add_round_key(q, sk + nr * 8);
+    bs_store(out, q);
+}
+
+static inline __attribute__((always_inline)) void
+bs_decrypt8(const aes_key_ctx *ctx, const byte *in, byte *out, const int nr)
+{
+    const uint64_t *sk = ctx->bsKeys;
+    bs_word q[8];
+
+    bs_load(q, in);
+    bs_add_round_key(q, sk + nr * 8);
+#pragma GCC unroll 16
+    for (int round = nr - 1; round > 0; round--) {
+        bs_inv_shift_rows(q);
+        bs_inv_sbox(q);
+        bs_add_round_key(q, sk + round * 8);
+        bs_inv_mix_columns(q);
+    }
+    bs_inv_shift_rows(q);
+    bs_inv_sbox(q);
+    bs_add_round_key(q, sk);
+    bs_store(out, q);
+}
+
+// 常量时间 SubWord：把一个字放进位切片状态的第一个分组，经过同一个S盒电路
+static uint32_t bs_sub_word(uint32_t x)
+{
+    bs_word q[8] = { { 0 } };
+    q[0][0] = x;
+    bs_ortho(q);
+    bs_sbox(q);
+    bs_ortho(q);
+    return (uint32_t)q[0][0];
+}
+
+// 密钥扩展与 key_expansion 相同，只是 SubWord 不查 Sbox 表；同时生成位切片形式的轮密钥
+static void bitslice_expand_key(aes_key_ctx *ctx, const byte *key, int with_dec)
+{
+    static const byte rcon[10] = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1b, 0x36 };
+    const int nr = ctx->rounds, nk = nr - 6;
+    uint32_t w[AES_MAX_RK_WORDS];
+
+    for (int i = 0; i < nk; i++) w[i] = load_le32(key + 4 * i);
+    for (int i = nk; i < Nb * (nr + 1); i++) {
+        uint32_t t = w[i - 1];
+        if (i % nk == 0) {
+            t = bs_sub_word((t >> 8) | (t << 24)) ^ rcon[i / nk - 1]; // 小端下 RotWord 为右移8位
+        } else if (nk > 6 && i % nk == 4) {
+            t = bs_sub_word(t);
+        }
+        w[i] = w[i - nk] ^ t;
+    }
+
+    for (int round = 0; round <= nr; round++) {
+        uint64_t k0, k1;
+        bs_word q[8];
+        interleave_in(&k0, &k1, w + round * Nb);
+        // 同一轮密钥复制到所有分组位置，再转成位切片形式
+        for (int i = 0; i < 4; i++) {
+            q[i] = (bs_word){ k0, k0 };
+            q[i + 4] = (bs_word){ k1, k1 };
+        }
+        bs_ortho(q);
+        for (int i = 0; i < 8; i++) ctx->bsKeys[round * 8 + i] = q[i][0];
+        for (int i = 0; i < Nb; i++) store_le32(ctx->roundKeys[round * Nb + i], w[round * Nb + i]);
+    }
+
+    if (with_dec)
+        inv_key_expansion(ctx->roundKeys, ctx->decKeys, nr);
+
+    secure_zero(w, sizeof(w));
+}
+
+// 不足8个的分组补零后走同一条路径，处理时间只取决于分组数
+static inline __attribute__((always_inline)) void
+bitslice_encrypt_blocks_body(const aes_key_ctx *ctx, const byte *in, byte *out, size_t nblocks, const int nr)
+{
+    while (nblocks >= BS_BLOCKS) {
+        bs_encrypt8(ctx, in, out, nr);
+        in += BS_BLOCKS * BLOCK_SIZE;
+        out += BS_BLOCKS * BLOCK_SIZE;
+        nblocks -= BS_BLOCKS;
+    }
+    if (nblocks > 0) {
+        byte tmp[BS_BLOCKS * BLOCK_SIZE] = { 0 };
+        memcpy(tmp, in, nblocks * BLOCK_SIZE);
+        bs_encrypt8(ctx, tmp, tmp, nr);
+        memcpy(out, tmp, nblocks * BLOCK_SIZE);
+    }
+}
+
+static inline __attribute__((always_inline)) void
+bitslice_decrypt_blocks_body(const aes_key_ctx *ctx, const byte *in, byte *out, size_t nblocks, const int nr)
+{
+    while (nblocks >= BS_BLOCKS) {
+        bs_decrypt8(ctx, in, out, nr);
+        in += BS_BLOCKS * BLOCK_SIZE;
+        out += BS_BLOCKS * BLOCK_SIZE;
+        nblocks -= BS_BLOCKS;
+    }
+    if (nblocks > 0) {
+        byte tmp[BS_BLOCKS * BLOCK_SIZE] = { 0 };
+        memcpy(tmp, in, nblocks * BLOCK_SIZE);
+        bs_decrypt8(ctx, tmp, tmp, nr);
+        memcpy(out, tmp, nblocks * BLOCK_SIZE);
+    }
+}
+
+#define BITSLICE_VARIANTS(nr)                                                                          \
+    static void bitslice_encrypt_blocks_##nr(const aes_key_ctx *ctx, const byte *in, byte *out, size_t nblocks) \
+    {                                                                                                  \
+        bitslice_encrypt_blocks_body(ctx, in, out, nblocks, nr);                                       \
+    }                                                                                                  \
+    static void bitslice_decrypt_blocks_##nr(const aes_key_ctx *ctx, const byte *in, byte *out, size_t nblocks) \
+    {                                                                                                  \
+        bitslice_decrypt_blocks_body(ctx, in, out, nblocks, nr);                                       \
+    }
+
+BITSLICE_VARIANTS(10)
+BITSLICE_VARIANTS(12)
+BITSLICE_VARIANTS(14)
+
+static void bitslice_encrypt_blocks(const aes_key_ctx *ctx, const byte *in, byte *out, size_t nblocks)
+{
+    AES_ROUNDS_DISPATCH(ctx->rounds, bitslice_encrypt_blocks, ctx, in, out, nblocks);
+}
+
+static void bitslice_decrypt_blocks(const aes_key_ctx *ctx, const byte *in, byte *out, size_t nblocks)
+{
+    AES_ROUNDS_DISPATCH(ctx->rounds, bitslice_decrypt_blocks, ctx, in, out, nblocks);
+}
+
+// 单分组也走8路电路，结果正确且常量时间，但只用到八分之一的吞吐
+static void bitslice_encrypt_block(const aes_key_ctx *ctx, const byte in[16], byte out[16])
+{
+    bitslice_encrypt_blocks(ctx, in, out, 1);
+}
+
+static void bitslice_decrypt_block(const aes_key_ctx *ctx, const byte in[16], byte out[16])
+{
+    bitslice_decrypt_blocks(ctx, in, out, 1);
+}
+
+const struct aes_engine aes_engine_bitslice = {
+    "bitslice", NULL, bitslice_expand_key, NULL,
+    bitslice_encrypt_block, bitslice_decrypt_block,
+    bitslice_encrypt_blocks, bitslice_decrypt_blocks, NULL,
+};
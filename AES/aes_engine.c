@@ -0,0 +1,185 @@
+#include "aes_engine.h"
+#include <stdatomic.h>
+
+// 已注册的引擎，按优先级从高到低排列：默认选择第一个当前CPU可用的引擎
+// 没有AES-NI时优先用常量时间的 vperm / 位切片引擎，查表实现只在显式选择时使用
+static const struct aes_engine *const engines[] = {
+    &aes_engine_aesni,
+    &aes_engine_vperm,
+    &aes_engine_bitslice,
+    &aes_engine_ttable,
+    &aes_engine_ref,
+};
+
+#define ENGINE_COUNT (sizeof(engines) / sizeof(engines[0]))
+
+// 当前默认引擎：首次使用时选择，aes_engine_select 可随时改写，多线程同时读写用原子操作
+static _Atomic(const struct aes_engine *) selected_engine = NULL;
+
+static int engine_usable(const struct aes_engine *e)
+{
+    return e->available == NULL || e->available();
+}
+
+const struct aes_engine *aes_engine_find(const char *name)
+{
+    for (size_t i = 0; i < ENGINE_COUNT; i++) {
+        if (strcmp(engines[i]->name, name) == 0 && engine_usable(engines[i])) {
+            return engines[i];
+        }
+    }
+    return NULL;
+}
+
+const struct aes_engine *aes_engine_default(void)
+{
+    const struct aes_engine *e = atomic_load_explicit(&selected_engine, memory_order_acquire);
+    if (e == NULL) {
+        const struct aes_engine *expected = NULL;
+#ifdef AES_DEFAULT_ENGINE
+        e = aes_engine_find(AES_DEFAULT_ENGINE);
+#endif
+        for (size_t i = 0; e == NULL && i < ENGINE_COUNT; i++) {
+            if (engine_usable(engines[i])) e = engines[i];
+        }
+        // 只在仍未选择时写入：不覆盖其他线程同时做出的自动选择或 aes_engine_select
+        if (!atomic_compare_exchange_strong_explicit(&selected_engine, &expected, e, memory_order_acq_rel,
+                                                     memory_order_acquire)) {
+            e = expected;
+        }
+    }
+    return e;
+}
+
+int aes_engine_select(const char *name)
+{
+    const struct aes_engine *e = aes_engine_find(name);
+    if (e == NULL) return -1;
+    atomic_store_explicit(&selected_engine, e, memory_order_release);
+    return 0;
+}
+
+size_t aes_engine_list(const char **names, size_t max)
+{
+    size_t n = 0;
+    for (size_t i = 0; i < ENGINE_COUNT && n < max; i++) {
+        if (engine_usable(engines[i])) names[n++] = engines[i]->name;
+    }
+    return n;
+}
+
+const char *aes_engine_name(const aes_key_ctx *ctx)
+{
+    return ctx->engine->name;
+}
+
+// 初始化密钥上下文：只做一次密钥扩展，之后的每个分组直接复用轮密钥
+// key_len 为 16/24/32 字节（AES-128/192/256），轮数记录在 ctx->rounds 中
+static int key_setup(aes_key_ctx *ctx, const byte *key, size_t key_len, const char *name, int with_dec)
+{
+    int rounds = aes_rounds_for_key(key_len);
+    const struct aes_engine *e = (name == NULL) ? aes_engine_default() : aes_engine_find(name);
+    if (rounds == 0 || e == NULL) return -1;
+
+    // 解密轮密钥（等价逆密码）在这里统一算一次，引擎自己的密钥扩展也要给出 decKeys
+    ctx->rounds = rounds;
+    if (e->expand_key != NULL) {
+        e->expand_key(ctx, key, with_dec);
+    } else {
+        key_expansion(key, rounds, ctx->roundKeys);
+        if (with_dec) inv_key_expansion(ctx->roundKeys, ctx->decKeys, rounds);
+    }
+    ctx->engine = e;
+    if (e->setup != NULL) e->setup(ctx, with_dec);
+    return 0;
+}
+
+int aes_key_setup_engine(aes_key_ctx *ctx, const byte *key, size_t key_len, const char *name)
+{
+    return key_setup(ctx, key, key_len, name, 1);
+}
+
+// 只加密的上下文（CTR 类模式）：不生成解密轮密钥，每条消息都要换密钥时省下这部分开销
+int aes_key_setup_encrypt_engine(aes_key_ctx *ctx, const byte *key, size_t key_len, const char *name)
+{
+    return key_setup(ctx, key, key_len, name, 0);
+}
+
+int aes_key_setup(aes_key_ctx *ctx, const byte *key, size_t key_len)
+{
+    return aes_key_setup_engine(ctx, key, key_len, NULL);
+}
+
+int aes_key_init_engine(aes_key_ctx *ctx, const byte key[16], const char *name)
+{
+    return aes_key_setup_engine(ctx, key, 16, name);
+}
+
+void aes_key_init(aes_key_ctx *ctx, const byte key[16])
+{
+    aes_key_setup_engine(ctx, key, 16, NULL);
+}
+
+// 清除密钥上下文中的轮密钥
+void aes_key_clear(aes_key_ctx *ctx)
+{
+    secure_zero(ctx, sizeof(*ctx));
+}
+
+void aes_encrypt_block(const aes_key_ctx *ctx, const byte input[16], byte output[16])
+{
+    ctx->engine->encrypt_block(ctx, input, output);
+}
+
+void aes_decrypt_block(const aes_key_ctx *ctx, const byte input[16], byte output[16])
+{
+    ctx->engine->decrypt_block(ctx, input, output);
+}
+
+void aes_encrypt_blocks(const aes_key_ctx *ctx, const byte *input, byte *output, size_t nblocks)
+{
+    if (ctx->engine->encrypt_blocks != NULL) {
+        ctx->engine->encrypt_blocks(ctx, input, output, nblocks);
+        return;
+    }
+    for (size_t i = 0; i < nblocks; i++) {
+        ctx->engine->encrypt_block(ctx, input + i * BLOCK_SIZE, output + i * BLOCK_SIZE);
+    }
+}
+
+void aes_decrypt_blocks(const aes_key_ctx *ctx, const byte *input, byte *output, size_t nblocks)
+{
+    if (ctx->engine->decrypt_blocks != NULL) {
+        ctx->engine->decrypt_blocks(ctx, input, output, nblocks);
+        return;
+    }
+    for (size_t i = 0; i < nblocks; i++) {
+        ctx->engine->decrypt_block(ctx, input + i * BLOCK_SIZE, output + i * BLOCK_SIZE);
+    }
+}
+
+void aes_cbc_encrypt_lanes(const aes_key_ctx *const ctxs[], byte *const ivs[], const byte *const in[],
+                           byte *const out[], size_t n, size_t nblocks)
+{
+    const struct aes_engine *e = ctxs[0]->engine;
+    int same = (e->cbc_encrypt_lanes != NULL);
+    for (size_t l = 1; same && l < n; l++) {
+        same = (ctxs[l]->engine == e && ctxs[l]->rounds == ctxs[0]->rounds);
+    }
+    if (same) {
+        e->cbc_encrypt_lanes(ctxs, ivs, in, out, n, nblocks);
+        return;
+    }
+    for (size_t b = 0; b < nblocks; b++) {
+        for (size_t l = 0; l < n; l++) {
+            byte block[BLOCK_SIZE];
+            xor_block(block, in[l] + b * BLOCK_SIZE, ivs[l]);
+            aes_encrypt_block(ctxs[l], block, ivs[l]);
+            memcpy(out[l] + b * BLOCK_SIZE, ivs[l], BLOCK_SIZE);
+        }
+    }
+}
+
+const struct aes_engine aes_engine_ref = {
+    "ref", NULL, NULL, NULL, aes_ref_encrypt_block, aes_ref_decrypt_block, NULL, NULL, NULL,
+};
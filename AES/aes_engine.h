@@ -0,0 +1,56 @@
+#ifndef AES_ENGINE_H
+#define AES_ENGINE_H
+
+#include "common.h"
+#include "crypto/aes.h"
+
+#define AES_MAX_LANES 8 // 多流接口一次最多交错的独立分组数
+
+// AES 引擎接口：各实现共用同一个密钥上下文，由 aes_key_init 在密钥扩展后调用 setup 做引擎专用的预处理
+struct aes_engine {
+    const char *name;
+    int (*available)(void);                                       // 当前CPU是否支持，NULL表示总是可用
+    // 引擎自己的密钥扩展，调用前已设置 ctx->rounds；with_dec 非0时同时给出 decKeys，为0时（只加密的上下文）跳过。
+    // NULL时使用 key_expansion + inv_key_expansion
+    void (*expand_key)(aes_key_ctx *ctx, const byte *key, int with_dec);
+    void (*setup)(aes_key_ctx *ctx, int with_dec);                // 可为NULL；with_dec 同上
+    void (*encrypt_block)(const aes_key_ctx *ctx, const byte in[16], byte out[16]);
+    void (*decrypt_block)(const aes_key_ctx *ctx, const byte in[16], byte out[16]);
+    // 多个互相独立的分组（CTR、CBC解密等可并行的模式），NULL时逐块调用单分组函数
+    void (*encrypt_blocks)(const aes_key_ctx *ctx, const byte *in, byte *out, size_t nblocks);
+    void (*decrypt_blocks)(const aes_key_ctx *ctx, const byte *in, byte *out, size_t nblocks);
+    // n（不超过 AES_MAX_LANES）条独立的CBC加密链各用自己的密钥上下文（同一引擎、同一密钥长度），每条链推进 nblocks 个分组，
+    // ivs[l] 为链值并在返回时更新；NULL时逐块调用单分组函数
+    void (*cbc_encrypt_lanes)(const aes_key_ctx *const ctxs[], byte *const ivs[], const byte *const in[],
+                              byte *const out[], size_t n, size_t nblocks);
+};
+
+// 每种密钥长度各有一份轮数为编译期常量、完全展开的实现 fn_10 / fn_12 / fn_14，按 ctx->rounds 选择，
+// 轮循环里不再有运行期计数器
+#define AES_ROUNDS_DISPATCH(rounds, fn, ...)                 \
+    do {                                                     \
+        switch (rounds) {                                    \
+        case AES256_ROUNDS: fn##_14(__VA_ARGS__); break;     \
+        case AES192_ROUNDS: fn##_12(__VA_ARGS__); break;     \
+        default: fn##_10(__VA_ARGS__); break;                \
+        }                                                    \
+    } while (0)
+
+extern const struct aes_engine aes_engine_ref;
+extern const struct aes_engine aes_engine_vperm;
+extern const struct aes_engine aes_engine_bitslice;
+extern const struct aes_engine aes_engine_ttable;
+extern const struct aes_engine aes_engine_aesni;
+
+// 参考实现（AESEncryption.c / AESDecryption.c）
+void aes_ref_encrypt_block(const aes_key_ctx *ctx, const byte in[16], byte out[16]);
+void aes_ref_decrypt_block(const aes_key_ctx *ctx, const byte in[16], byte out[16]);
+
+// 多路CBC加密的分发：所有上下文同属一个支持多路的引擎且密钥长度相同时交给引擎交错执行，否则逐块加密
+void aes_cbc_encrypt_lanes(const aes_key_ctx *const ctxs[], byte *const ivs[], const byte *const in[],
+                           byte *const out[], size_t n, size_t nblocks);
+
+const struct aes_engine *aes_engine_find(const char *name);
+const struct aes_engine *aes_engine_default(void);
+
+#endif // AES_ENGINE_H
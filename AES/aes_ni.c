@@ -0,0 +1,312 @@
+#include "aes_engine.h"
+#include "crypto/cpu.h"
+
+// AES-NI 硬件引擎：AESKEYGENASSIST 做密钥扩展，AESENC/AESDEC 做轮函数
+// 函数用 target 属性单独开启指令集，整个库不需要 -maes 编译，运行期通过 CPUID 决定是否使用
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <wmmintrin.h>
+#include <emmintrin.h>
+
+#define AESNI_TARGET __attribute__((target("aes,sse2")))
+#define AESNI_BATCH 8 // 每次并行处理的分组数，足以填满 AESENC 的流水线
+
+static int aesni_available(void)
+{
+    return crypto_cpu_has(CPU_FEATURE_AESNI | CPU_FEATURE_SSE2);
+}
+
+// 一步 AES-128 密钥扩展：w[i] = w[i-4] ^ SubWord(RotWord(w[i-1])) ^ Rcon
+// AES-256 的偶数步相同（assist 来自上一个 128 位半块）
+AESNI_TARGET static __m128i key_step(__m128i key, __m128i assist)
+{
+    assist = _mm_shuffle_epi32(assist, 0xff);
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    return _mm_xor_si128(key, assist);
+}
+
+// AES-256 的奇数步：w[i] = w[i-8] ^ SubWord(w[i-1])，不做 RotWord 也没有 Rcon
+AESNI_TARGET static __m128i key_step_sub(__m128i key, __m128i prev)
+{
+    __m128i assist = _mm_shuffle_epi32(_mm_aeskeygenassist_si128(prev, 0x00), 0xaa);
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    return _mm_xor_si128(key, assist);
+}
+
+// AESKEYGENASSIST 的轮常量必须是立即数
+#define KEY_STEP(k, rcon) key_step((k), _mm_aeskeygenassist_si128((k), (rcon)))
+#define KEY_STEP_256(k, prev, rcon) key_step((k), _mm_aeskeygenassist_si128((prev), (rcon)))
+
+// 常量时间的 SubWord：AESKEYGENASSIST 结果的第0个字为 SubWord(第1个字)
+AESNI_TARGET static uint32_t aesni_sub_word(uint32_t w)
+{
+    return (uint32_t)_mm_cvtsi128_si32(_mm_aeskeygenassist_si128(_mm_set1_epi32((int)w), 0x00));
+}
+
+AESNI_TARGET static void aesni_expand_key(aes_key_ctx *ctx, const byte *key, int with_dec)
+{
+    const int nr = ctx->rounds;
+    __m128i rk[AES_MAX_ROUNDS + 1];
+
+    if (nr == AES128_ROUNDS) {
+        rk[0] = _mm_loadu_si128((const __m128i *)key);
+        rk[1] = KEY_STEP(rk[0], 0x01);
+        rk[2] = KEY_STEP(rk[1], 0x02);
+        rk[3] = KEY_STEP(rk[2], 0x04);
+        rk[4] = KEY_STEP(rk[3], 0x08);
+        rk[5] = KEY_STEP(rk[4], 0x10);
+        rk[6] = KEY_STEP(rk[5], 0x20);
+        rk[7] = KEY_STEP(rk[6], 0x40);
+        rk[8] = KEY_STEP(rk[7], 0x80);
+        rk[9] = KEY_STEP(rk[8], 0x1b);
+        rk[10] = KEY_STEP(rk[9], 0x36);
+    } else if (nr == AES256_ROUNDS) {
+        rk[0] = _mm_loadu_si128((const __m128i *)key);
+        rk[1] = _mm_loadu_si128((const __m128i *)(key + 16));
+        rk[2] = KEY_STEP_256(rk[0], rk[1], 0x01);
+        rk[3] = key_step_sub(rk[1], rk[2]);
+        rk[4] = KEY_STEP_256(rk[2], rk[3], 0x02);
+        rk[5] = key_step_sub(rk[3], rk[4]);
+        rk[6] = KEY_STEP_256(rk[4], rk[5], 0x04);
+        rk[7] = key_step_sub(rk[5], rk[6]);
+        rk[8] = KEY_STEP_256(rk[6], rk[7], 0x08);
+        rk[9] = key_step_sub(rk[7], rk[8]);
+        rk[10] = KEY_STEP_256(rk[8], rk[9], 0x10);
+        rk[11] = key_step_sub(rk[9], rk[10]);
+        rk[12] = KEY_STEP_256(rk[10], rk[11], 0x20);
+        rk[13] = key_step_sub(rk[11], rk[12]);
+        rk[14] = KEY_STEP_256(rk[12], rk[13], 0x40);
+    } else {
+        // AES-192 每次产生 6 个字，与 128 位轮密钥错位，按字扩展更直接
+        static const byte rcon[8] = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80 };
+        uint32_t w[Nb * (AES192_ROUNDS + 1)];
+        memcpy(w, key, 24);
+        for (int i = 6; i < Nb * (AES192_ROUNDS + 1); i++) {
+            uint32_t t = w[i - 1];
+            if (i % 6 == 0) {
+                t = aesni_sub_word((t >> 8) | (t << 24)) ^ rcon[i / 6 - 1]; // 小端下 RotWord 为右移8位
+            }
+            w[i] = w[i - 6] ^ t;
+        }
+        for (int i = 0; i <= nr; i++) rk[i] = _mm_loadu_si128((const __m128i *)(w + i * Nb));
+    }
+
+    for (int i = 0; i <= nr; i++)
+        _mm_storeu_si128((__m128i *)ctx->roundKeys[i * Nb], rk[i]);
+    if (!with_dec)
+        return;
+    // 解密轮密钥：逆序排列，中间各轮做 AESIMC（即 InvMixColumns）
+    for (int i = 0; i <= nr; i++) {
+        __m128i d = (i == 0 || i == nr) ? rk[nr - i] : _mm_aesimc_si128(rk[nr - i]);
+        _mm_storeu_si128((__m128i *)ctx->decKeys[i * Nb], d);
+    }
+}
+
+// 以下各函数体的轮数 nr 在每种密钥长度的实例中是常量，always_inline 加 unroll 使轮序列完全展开
+#define AESNI_INLINE static inline __attribute__((always_inline)) AESNI_TARGET
+
+AESNI_INLINE void aesni_encrypt_body(const aes_key_ctx *ctx, const byte in[16], byte out[16], const int nr)
+{
+    const __m128i *rk = (const __m128i *)ctx->roundKeys;
+    __m128i m = _mm_xor_si128(_mm_loadu_si128((const __m128i *)in), _mm_loadu_si128(rk));
+#pragma GCC unroll 16
+    for (int i = 1; i < nr; i++) {
+        m = _mm_aesenc_si128(m, _mm_loadu_si128(rk + i));
+    }
+    m = _mm_aesenclast_si128(m, _mm_loadu_si128(rk + nr));
+    _mm_storeu_si128((__m128i *)out, m);
+}
+
+AESNI_INLINE void aesni_decrypt_body(const aes_key_ctx *ctx, const byte in[16], byte out[16], const int nr)
+{
+    const __m128i *dk = (const __m128i *)ctx->decKeys;
+    __m128i m = _mm_xor_si128(_mm_loadu_si128((const __m128i *)in), _mm_loadu_si128(dk));
+#pragma GCC unroll 16
+    for (int i = 1; i < nr; i++) {
+        m = _mm_aesdec_si128(m, _mm_loadu_si128(dk + i));
+    }
+    m = _mm_aesdeclast_si128(m, _mm_loadu_si128(dk + nr));
+    _mm_storeu_si128((__m128i *)out, m);
+}
+
+// 8个分组交错执行：每条 AESENC 有数个周期的延迟，独立分组可以填满流水线
+AESNI_INLINE void aesni_encrypt_blocks_body(const aes_key_ctx *ctx, const byte *in, byte *out, size_t nblocks,
+                                            const int nr)
+{
+    const __m128i *rk = (const __m128i *)ctx->roundKeys;
+    __m128i m[AESNI_BATCH];
+    int b, i;
+
+    while (nblocks >= AESNI_BATCH) {
+        __m128i k = _mm_loadu_si128(rk);
+        for (b = 0; b < AESNI_BATCH; b++) {
+            m[b] = _mm_xor_si128(_mm_loadu_si128((const __m128i *)in + b), k);
+        }
+#pragma GCC unroll 16
+        for (i = 1; i < nr; i++) {
+            k = _mm_loadu_si128(rk + i);
+#pragma GCC unroll 8
+            for (b = 0; b < AESNI_BATCH; b++) m[b] = _mm_aesenc_si128(m[b], k);
+        }
+        k = _mm_loadu_si128(rk + nr);
+        for (b = 0; b < AESNI_BATCH; b++) {
+            _mm_storeu_si128((__m128i *)out + b, _mm_aesenclast_si128(m[b], k));
+        }
+        in += AESNI_BATCH * BLOCK_SIZE;
+        out += AESNI_BATCH * BLOCK_SIZE;
+        nblocks -= AESNI_BATCH;
+    }
+    for (; nblocks > 0; nblocks--) {
+        aesni_encrypt_body(ctx, in, out, nr);
+        in += BLOCK_SIZE;
+        out += BLOCK_SIZE;
+    }
+}
+
+AESNI_INLINE void aesni_decrypt_blocks_body(const aes_key_ctx *ctx, const byte *in, byte *out, size_t nblocks,
+                                            const int nr)
+{
+    const __m128i *dk = (const __m128i *)ctx->decKeys;
+    __m128i m[AESNI_BATCH];
+    int b, i;
+
+    while (nblocks >= AESNI_BATCH) {
+        __m128i k = _mm_loadu_si128(dk);
+        for (b = 0; b < AESNI_BATCH; b++) {
+            m[b] = _mm_xor_si128(_mm_loadu_si128((const __m128i *)in + b), k);
+        }
+#pragma GCC unroll 16
+        for (i = 1; i < nr; i++) {
+            k = _mm_loadu_si128(dk + i);
+#pragma GCC unroll 8
+            for (b = 0; b < AESNI_BATCH; b++) m[b] = _mm_aesdec_si128(m[b], k);
+        }
+        k = _mm_loadu_si128(dk + nr);
+        for (b = 0; b < AESNI_BATCH; b++) {
+            _mm_storeu_si128((__m128i *)out + b, _mm_aesdeclast_si128(m[b], k));
+        }
+        in += AESNI_BATCH * BLOCK_SIZE;
+        out += AESNI_BATCH * BLOCK_SIZE;
+        nblocks -= AESNI_BATCH;
+    }
+    for (; nblocks > 0; nblocks--) {
+        aesni_decrypt_body(ctx, in, out, nr);
+        in += BLOCK_SIZE;
+        out += BLOCK_SIZE;
+    }
+}
+
+// 多路CBC加密：每条链使用各自上下文的轮密钥，多条独立的链同时占满 AESENC 流水线
+// 通道数与轮数都为常量的调用被完全展开，链值保存在寄存器中
+AESNI_INLINE void aesni_cbc_lanes_body(const aes_key_ctx *const ctxs[], byte *const ivs[], const byte *const in[],
+                                       byte *const out[], size_t n, size_t nblocks, const int nr)
+{
+    __m128i c[AES_MAX_LANES];
+    for (size_t l = 0; l < n; l++) c[l] = _mm_loadu_si128((const __m128i *)ivs[l]);
+    for (size_t b = 0; b < nblocks; b++) {
+#pragma GCC unroll 8
+        for (size_t l = 0; l < n; l++) {
+            __m128i m = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(in[l] + b * BLOCK_SIZE)), c[l]);
+            c[l] = _mm_xor_si128(m, _mm_loadu_si128((const __m128i *)ctxs[l]->roundKeys));
+        }
+#pragma GCC unroll 16
+        for (int round = 1; round < nr; round++) {
+#pragma GCC unroll 8
+            for (size_t l = 0; l < n; l++) {
+                c[l] = _mm_aesenc_si128(c[l], _mm_loadu_si128((const __m128i *)ctxs[l]->roundKeys + round));
+            }
+        }
+#pragma GCC unroll 8
+        for (size_t l = 0; l < n; l++) {
+            c[l] = _mm_aesenclast_si128(c[l], _mm_loadu_si128((const __m128i *)ctxs[l]->roundKeys + nr));
+            _mm_storeu_si128((__m128i *)(out[l] + b * BLOCK_SIZE), c[l]);
+        }
+    }
+    for (size_t l = 0; l < n; l++) _mm_storeu_si128((__m128i *)ivs[l], c[l]);
+}
+
+// 每种密钥长度一组实例
+#define AESNI_VARIANTS(nr)                                                                             \
+    AESNI_TARGET static void aesni_encrypt_block_##nr(const aes_key_ctx *ctx, const byte in[16], byte out[16]) \
+    {                                                                                                  \
+        aesni_encrypt_body(ctx, in, out, nr);                                                          \
+    }                                                                                                  \
+    AESNI_TARGET static void aesni_decrypt_block_##nr(const aes_key_ctx *ctx, const byte in[16], byte out[16]) \
+    {                                                                                                  \
+        aesni_decrypt_body(ctx, in, out, nr);                                                          \
+    }                                                                                                  \
+    AESNI_TARGET static void aesni_encrypt_blocks_##nr(const aes_key_ctx *ctx, const byte *in, byte *out, \
+                                                       size_t nblocks)                                 \
+    {                                                                                                  \
+        aesni_encrypt_blocks_body(ctx, in, out, nblocks, nr);                                          \
+    }                                                                                                  \
+    AESNI_TARGET static void aesni_decrypt_blocks_##nr(const aes_key_ctx *ctx, const byte *in, byte *out, \
+                                                       size_t nblocks)                                 \
+    {                                                                                                  \
+        aesni_decrypt_blocks_body(ctx, in, out, nblocks, nr);                                          \
+    }                                                                                                  \
+    AESNI_TARGET static void aesni_cbc_encrypt_lanes_##nr(const aes_key_ctx *const ctxs[], byte *const ivs[], \
+                                                          const byte *const in[], byte *const out[],   \
+                                                          size_t n, size_t nblocks)                    \
+    {                                                                                                  \
+        if (n == AES_MAX_LANES) {                                                                      \
+            aesni_cbc_lanes_body(ctxs, ivs, in, out, AES_MAX_LANES, nblocks, nr);                      \
+        } else {                                                                                       \
+            aesni_cbc_lanes_body(ctxs, ivs, in, out, n, nblocks, nr);                                  \
+        }                                                                                              \
+    }
+
+AESNI_VARIANTS(10)
+AESNI_VARIANTS(12)
+AESNI_VARIANTS(14)
+
+static void aesni_encrypt_block(const aes_key_ctx *ctx, const byte in[16], byte out[16])
+{
+    AES_ROUNDS_DISPATCH(ctx->rounds, aesni_encrypt_block, ctx, in, out);
+}
+
+static void aesni_decrypt_block(const aes_key_ctx *ctx, const byte in[16], byte out[16])
+{
+    AES_ROUNDS_DISPATCH(ctx->rounds, aesni_decrypt_block, ctx, in, out);
+}
+
+static void aesni_encrypt_blocks(const aes_key_ctx *ctx, const byte *in, byte *out, size_t nblocks)
+{
+    AES_ROUNDS_DISPATCH(ctx->rounds, aesni_encrypt_blocks, ctx, in, out, nblocks);
+}
+
+static void aesni_decrypt_blocks(const aes_key_ctx *ctx, const byte *in, byte *out, size_t nblocks)
+{
+    AES_ROUNDS_DISPATCH(ctx->rounds, aesni_decrypt_blocks, ctx, in, out, nblocks);
+}
+
+// 分发层保证所有通道的密钥长度相同
+static void aesni_cbc_encrypt_lanes(const aes_key_ctx *const ctxs[], byte *const ivs[], const byte *const in[],
+                                    byte *const out[], size_t n, size_t nblocks)
+{
+    AES_ROUNDS_DISPATCH(ctxs[0]->rounds, aesni_cbc_encrypt_lanes, ctxs, ivs, in, out, n, nblocks);
+}
+
+const struct aes_engine aes_engine_aesni = {
+    "aesni", aesni_available, aesni_expand_key, NULL,
+    aesni_encrypt_block, aesni_decrypt_block, aesni_encrypt_blocks, aesni_decrypt_blocks,
+    aesni_cbc_encrypt_lanes,
+};
+
+#else
+
+// 非x86平台：引擎永远不可用，不会被选中
+static int aesni_available(void)
+{
+    return 0;
+}
+
+const struct aes_engine aes_engine_aesni = {
+    "aesni", aesni_available, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+};
+
+#endif
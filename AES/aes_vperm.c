@@ -0,0 +1,345 @@
+#include "aes_engine.h"
+#include "crypto/cpu.h"
+
+// 向量置换（vpaes 风格）常量时间AES引擎：S盒不查内存表，而是用 PSHUFB 在寄存器里做16项的半字节查找
+// 思路（Hamburg 2009）：把字节换到塔域 GF((2^4)^2) 的基下，x = i·t + j·t'（t、t' 为 t^2+t+ζ 的两个根），
+// GF(2^8) 求逆化为几次 GF(2^4) 求逆，每次求逆都是一条 PSHUFB；基变换和仿射变换是线性的，拆成高低半字节两次 PSHUFB
+// 状态在各轮之间仍是 FIPS-197 的字节布局，ShiftRows 为一次字节置换，MixColumns 用列内旋转和 xtime 完成
+// 常量由 GF(2^8) 直接推导，并对全部256个输入与 Sbox/InvSBox 做过逐一核对
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <tmmintrin.h>
+
+#define VPERM_TARGET __attribute__((target("ssse3")))
+#define VPERM_BATCH 4 // 多分组时交错处理的分组数，用来掩盖 PSHUFB 依赖链的延迟
+#define VPERM_INLINE static inline __attribute__((always_inline)) VPERM_TARGET
+
+#define ALIGN16 __attribute__((aligned(16)))
+
+// 标准基 -> 塔域基（高半字节 i，低半字节 k = i ^ j），按输入的低/高半字节拆成两张表
+static const byte ipt_lo[16] ALIGN16 = {
+    0x00, 0x10, 0xc6, 0xd6, 0x8d, 0x9d, 0x4b, 0x5b, 0xbd, 0xad, 0x7b, 0x6b, 0x30, 0x20, 0xf6, 0xe6
+};
+static const byte ipt_hi[16] ALIGN16 = {
+    0x00, 0x67, 0x79, 0x1e, 0x37, 0x50, 0x4e, 0x29, 0x9e, 0xf9, 0xe7, 0x80, 0xa9, 0xce, 0xd0, 0xb7
+};
+// 解密输入：先去掉常量 0x63、做逆仿射，再换到塔域基
+static const byte dipt_lo[16] ALIGN16 = {
+    0x9d, 0xd1, 0xe9, 0xa5, 0x49, 0x05, 0x3d, 0x71, 0x0b, 0x47, 0x7f, 0x33, 0xdf, 0x93, 0xab, 0xe7
+};
+static const byte dipt_hi[16] ALIGN16 = {
+    0x00, 0x6a, 0x9a, 0xf0, 0x3f, 0x55, 0xa5, 0xcf, 0xe4, 0x8e, 0x7e, 0x14, 0xdb, 0xb1, 0x41, 0x2b
+};
+// GF(2^4) 求逆，0 映射为 0x80（“无穷”），PSHUFB 遇到最高位为1的索引输出0，正好是 1/∞ = 0
+static const byte inv_tab[16] ALIGN16 = {
+    0x80, 0x01, 0x0c, 0x08, 0x06, 0x0f, 0x04, 0x0e, 0x03, 0x0d, 0x0b, 0x0a, 0x02, 0x09, 0x07, 0x05
+};
+// 1/(ζ·k)
+static const byte inv_zk[16] ALIGN16 = {
+    0x80, 0x08, 0x04, 0x0f, 0x02, 0x05, 0x0b, 0x0d, 0x01, 0x0c, 0x0e, 0x06, 0x09, 0x07, 0x0a, 0x03
+};
+// 输出：两个 GF(2^4) 中间量各自求逆后换回标准基；加密表另外并入S盒的仿射变换（常量0x63单独异或）
+static const byte sbo_u[16] ALIGN16 = {
+    0x00, 0x4d, 0x83, 0x98, 0x8c, 0x59, 0x1b, 0x14, 0xda, 0xce, 0x42, 0x0f, 0x97, 0xd5, 0xc1, 0x56
+};
+static const byte sbo_t[16] ALIGN16 = {
+    0x00, 0x52, 0x37, 0x05, 0x3e, 0x69, 0x32, 0x3b, 0x5e, 0x65, 0x5b, 0x09, 0x0c, 0x57, 0x6c, 0x60
+};
+static const byte dso_u[16] ALIGN16 = {
+    0x00, 0xa3, 0xfb, 0xd3, 0x5e, 0x2e, 0x28, 0x8d, 0xd5, 0x58, 0x06, 0xa5, 0x76, 0x70, 0xfd, 0x8b
+};
+static const byte dso_t[16] ALIGN16 = {
+    0x00, 0xa2, 0x1a, 0x63, 0x02, 0xc3, 0x79, 0x61, 0xd9, 0xb8, 0xba, 0x18, 0x7b, 0xc1, 0xa0, 0xdb
+};
+// 字节置换：ShiftRows、InvShiftRows、列内旋转1字节、列内旋转2字节
+static const byte shift_rows_mask[16] ALIGN16 = { 0, 5, 10, 15, 4, 9, 14, 3, 8, 13, 2, 7, 12, 1, 6, 11 };
+static const byte inv_shift_rows_mask[16] ALIGN16 = { 0, 13, 10, 7, 4, 1, 14, 11, 8, 5, 2, 15, 12, 9, 6, 3 };
+static const byte rot1_mask[16] ALIGN16 = { 1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12 };
+static const byte rot2_mask[16] ALIGN16 = { 2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13 };
+
+#define LOAD_TAB(t) _mm_load_si128((const __m128i *)(t))
+
+static int vperm_available(void)
+{
+    return crypto_cpu_has(CPU_FEATURE_SSSE3);
+}
+
+// 塔域求逆的公共部分：输入为塔域坐标，输出两个中间量 io、jo（各自的倒数线性组合出 x^-1）
+// x^-1 的范数 N = ζk^2 + ij，io = N/(ζk + i)，jo = N/(ζk + j)；全部通过 1/(1/a + 1/(ζk)) 的形式计算
+VPERM_TARGET static void tower_inverse(__m128i x, __m128i *io, __m128i *jo)
+{
+    const __m128i mask = _mm_set1_epi8(0x0f);
+    const __m128i inv = LOAD_TAB(inv_tab);
+    __m128i i = _mm_and_si128(_mm_srli_epi32(x, 4), mask);
+    __m128i k = _mm_and_si128(x, mask);
+    __m128i j = _mm_xor_si128(i, k);
+    __m128i ak = _mm_shuffle_epi8(LOAD_TAB(inv_zk), k);
+    __m128i iak = _mm_xor_si128(_mm_shuffle_epi8(inv, i), ak);
+    __m128i jak = _mm_xor_si128(_mm_shuffle_epi8(inv, j), ak);
+    *io = _mm_xor_si128(_mm_shuffle_epi8(inv, iak), j);
+    *jo = _mm_xor_si128(_mm_shuffle_epi8(inv, jak), i);
+}
+
+// 16字节的线性变换：低、高半字节各查一次表后异或
+VPERM_TARGET static __m128i nibble_transform(__m128i x, const byte lo[16], const byte hi[16])
+{
+    const __m128i mask = _mm_set1_epi8(0x0f);
+    __m128i l = _mm_shuffle_epi8(LOAD_TAB(lo), _mm_and_si128(x, mask));
+    __m128i h = _mm_shuffle_epi8(LOAD_TAB(hi), _mm_and_si128(_mm_srli_epi32(x, 4), mask));
+    return _mm_xor_si128(l, h);
+}
+
+VPERM_TARGET static __m128i sub_bytes(__m128i x)
+{
+    __m128i io, jo;
+    tower_inverse(nibble_transform(x, ipt_lo, ipt_hi), &io, &jo);
+    x = _mm_xor_si128(_mm_shuffle_epi8(LOAD_TAB(sbo_u), io), _mm_shuffle_epi8(LOAD_TAB(sbo_t), jo));
+    return _mm_xor_si128(x, _mm_set1_epi8(0x63));
+}
+
+VPERM_TARGET static __m128i inv_sub_bytes(__m128i x)
+{
+    __m128i io, jo;
+    tower_inverse(nibble_transform(x, dipt_lo, dipt_hi), &io, &jo);
+    return _mm_xor_si128(_mm_shuffle_epi8(LOAD_TAB(dso_u), io), _mm_shuffle_epi8(LOAD_TAB(dso_t), jo));
+}
+
+// 每个字节乘 {02}：左移1位，最高位为1的字节再异或 0x1b
+VPERM_TARGET static __m128i xtime128(__m128i x)
+{
+    __m128i carry = _mm_cmplt_epi8(x, _mm_setzero_si128());
+    return _mm_xor_si128(_mm_add_epi8(x, x), _mm_and_si128(carry, _mm_set1_epi8(0x1b)));
+}
+
+// b_r = 2a_r ^ 3a_{r+1} ^ a_{r+2} ^ a_{r+3} = 2(a ^ rot1(a)) ^ rot1(a) ^ rot2(a ^ rot1(a))
+VPERM_TARGET static __m128i mix_columns(__m128i a)
+{
+    __m128i r1 = _mm_shuffle_epi8(a, LOAD_TAB(rot1_mask));
+    __m128i t = _mm_xor_si128(a, r1);
+    __m128i r2 = _mm_shuffle_epi8(t, LOAD_TAB(rot2_mask));
+    return _mm_xor_si128(_mm_xor_si128(xtime128(t), r1), r2);
+}
+
+// InvMixColumns = MixColumns ∘ P，P(a) = a ^ 4·(a ^ rot2(a))
+VPERM_TARGET static __m128i inv_mix_columns(__m128i a)
+{
+    __m128i t = _mm_xor_si128(a, _mm_shuffle_epi8(a, LOAD_TAB(rot2_mask)));
+    a = _mm_xor_si128(a, xtime128(xtime128(t)));
+    return mix_columns(a);
+}
+
+// 以下各函数体的轮数 nr 在每种密钥长度的实例中是常量，always_inline 加 unroll 使轮序列完全展开
+VPERM_INLINE __m128i encrypt_m128(const aes_key_ctx *ctx, __m128i m, const int nr)
+{
+    const __m128i *rk = (const __m128i *)ctx->roundKeys;
+    const __m128i sr = LOAD_TAB(shift_rows_mask);
+    m = _mm_xor_si128(m, _mm_loadu_si128(rk));
+#pragma GCC unroll 16
+    for (int round = 1; round < nr; round++) {
+        m = _mm_shuffle_epi8(sub_bytes(m), sr);
+        m = _mm_xor_si128(mix_columns(m), _mm_loadu_si128(rk + round));
+    }
+    m = _mm_shuffle_epi8(sub_bytes(m), sr);
+    return _mm_xor_si128(m, _mm_loadu_si128(rk + nr));
+}
+
+VPERM_INLINE __m128i decrypt_m128(const aes_key_ctx *ctx, __m128i m, const int nr)
+{
+    const __m128i *rk = (const __m128i *)ctx->roundKeys;
+    const __m128i isr = LOAD_TAB(inv_shift_rows_mask);
+    m = _mm_xor_si128(m, _mm_loadu_si128(rk + nr));
+#pragma GCC unroll 16
+    for (int round = nr - 1; round > 0; round--) {
+        m = inv_sub_bytes(_mm_shuffle_epi8(m, isr));
+        m = inv_mix_columns(_mm_xor_si128(m, _mm_loadu_si128(rk + round)));
+    }
+    m = inv_sub_bytes(_mm_shuffle_epi8(m, isr));
+    return _mm_xor_si128(m, _mm_loadu_si128(rk));
+}
+
+VPERM_INLINE void vperm_encrypt_body(const aes_key_ctx *ctx, const byte in[16], byte out[16], const int nr)
+{
+    __m128i m = encrypt_m128(ctx, _mm_loadu_si128((const __m128i *)in), nr);
+    _mm_storeu_si128((__m128i *)out, m);
+}
+
+VPERM_INLINE void vperm_decrypt_body(const aes_key_ctx *ctx, const byte in[16], byte out[16], const int nr)
+{
+    __m128i m = decrypt_m128(ctx, _mm_loadu_si128((const __m128i *)in), nr);
+    _mm_storeu_si128((__m128i *)out, m);
+}
+
+// 4个分组交错执行：单个分组的S盒是一条较长的 PSHUFB 依赖链，独立分组可以并行发射
+VPERM_INLINE void vperm_encrypt_blocks_body(const aes_key_ctx *ctx, const byte *in, byte *out, size_t nblocks,
+                                            const int nr)
+{
+    const __m128i *rk = (const __m128i *)ctx->roundKeys;
+    const __m128i sr = LOAD_TAB(shift_rows_mask);
+    while (nblocks >= VPERM_BATCH) {
+        __m128i m[VPERM_BATCH];
+        __m128i k = _mm_loadu_si128(rk);
+        for (int b = 0; b < VPERM_BATCH; b++) {
+            m[b] = _mm_xor_si128(_mm_loadu_si128((const __m128i *)in + b), k);
+        }
+#pragma GCC unroll 16
+        for (int round = 1; round < nr; round++) {
+            k = _mm_loadu_si128(rk + round);
+            for (int b = 0; b < VPERM_BATCH; b++) {
+                m[b] = _mm_xor_si128(mix_columns(_mm_shuffle_epi8(sub_bytes(m[b]), sr)), k);
+            }
+        }
+        k = _mm_loadu_si128(rk + nr);
+        for (int b = 0; b < VPERM_BATCH; b++) {
+            _mm_storeu_si128((__m128i *)out + b, _mm_xor_si128(_mm_shuffle_epi8(sub_bytes(m[b]), sr), k));
+        }
+        in += VPERM_BATCH * BLOCK_SIZE;
+        out += VPERM_BATCH * BLOCK_SIZE;
+        nblocks -= VPERM_BATCH;
+    }
+    for (; nblocks > 0; nblocks--, in += BLOCK_SIZE, out += BLOCK_SIZE) {
+        vperm_encrypt_body(ctx, in, out, nr);
+    }
+}
+
+VPERM_INLINE void vperm_decrypt_blocks_body(const aes_key_ctx *ctx, const byte *in, byte *out, size_t nblocks,
+                                            const int nr)
+{
+    const __m128i *rk = (const __m128i *)ctx->roundKeys;
+    const __m128i isr = LOAD_TAB(inv_shift_rows_mask);
+    while (nblocks >= VPERM_BATCH) {
+        __m128i m[VPERM_BATCH];
+        __m128i k = _mm_loadu_si128(rk + nr);
+        for (int b = 0; b < VPERM_BATCH; b++) {
+            m[b] = _mm_xor_si128(_mm_loadu_si128((const __m128i *)in + b), k);
+        }
+#pragma GCC unroll 16
+        for (int round = nr - 1; round > 0; round--) {
+            k = _mm_loadu_si128(rk + round);
+            for (int b = 0; b < VPERM_BATCH; b++) {
+                m[b] = inv_mix_columns(_mm_xor_si128(inv_sub_bytes(_mm_shuffle_epi8(m[b], isr)), k));
+            }
+        }
+        k = _mm_loadu_si128(rk);
+        for (int b = 0; b < VPERM_BATCH; b++) {
+            _mm_storeu_si128((__m128i *)out + b, _mm_xor_si128(inv_sub_bytes(_mm_shuffle_epi8(m[b], isr)), k));
+        }
+        in += VPERM_BATCH * BLOCK_SIZE;
+        out += VPERM_BATCH * BLOCK_SIZE;
+        nblocks -= VPERM_BATCH;
+    }
+    for (; nblocks > 0; nblocks--, in += BLOCK_SIZE, out += BLOCK_SIZE) {
+        vperm_decrypt_body(ctx, in, out, nr);
+    }
+}
+
+// 多路CBC加密：每条链用各自的轮密钥，交错方式与 vperm_encrypt_blocks 相同
+VPERM_INLINE void vperm_cbc_lanes_body(const aes_key_ctx *const ctxs[], byte *const ivs[], const byte *const in[],
+                                       byte *const out[], size_t n, size_t nblocks, const int nr)
+{
+    const __m128i sr = LOAD_TAB(shift_rows_mask);
+    __m128i c[AES_MAX_LANES];
+    for (size_t l = 0; l < n; l++) c[l] = _mm_loadu_si128((const __m128i *)ivs[l]);
+    for (size_t b = 0; b < nblocks; b++) {
+        for (size_t l = 0; l < n; l++) {
+            __m128i m = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(in[l] + b * BLOCK_SIZE)), c[l]);
+            c[l] = _mm_xor_si128(m, _mm_loadu_si128((const __m128i *)ctxs[l]->roundKeys));
+        }
+#pragma GCC unroll 16
+        for (int round = 1; round < nr; round++) {
+            for (size_t l = 0; l < n; l++) {
+                __m128i k = _mm_loadu_si128((const __m128i *)ctxs[l]->roundKeys + round);
+                c[l] = _mm_xor_si128(mix_columns(_mm_shuffle_epi8(sub_bytes(c[l]), sr)), k);
+            }
+        }
+        for (size_t l = 0; l < n; l++) {
+            __m128i k = _mm_loadu_si128((const __m128i *)ctxs[l]->roundKeys + nr);
+            c[l] = _mm_xor_si128(_mm_shuffle_epi8(sub_bytes(c[l]), sr), k);
+            _mm_storeu_si128((__m128i *)(out[l] + b * BLOCK_SIZE), c[l]);
+        }
+    }
+    for (size_t l = 0; l < n; l++) _mm_storeu_si128((__m128i *)ivs[l], c[l]);
+}
+
+#define VPERM_VARIANTS(nr)                                                                             \
+    VPERM_TARGET static void vperm_encrypt_block_##nr(const aes_key_ctx *ctx, const byte in[16], byte out[16]) \
+    {                                                                                                  \
+        vperm_encrypt_body(ctx, in, out, nr);                                                          \
+    }                                                                                                  \
+    VPERM_TARGET static void vperm_decrypt_block_##nr(const aes_key_ctx *ctx, const byte in[16], byte out[16]) \
+    {                                                                                                  \
+        vperm_decrypt_body(ctx, in, out, nr);                                                          \
+    }                                                                                                  \
+    VPERM_TARGET static void vperm_encrypt_blocks_##nr(const aes_key_ctx *ctx, const byte *in, byte *out, \
+                                                       size_t nblocks)                                 \
+    {                                                                                                  \
+        vperm_encrypt_blocks_body(ctx, in, out, nblocks, nr);                                          \
+    }                                                                                                  \
+    VPERM_TARGET static void vperm_decrypt_blocks_##nr(const aes_key_ctx *ctx, const byte *in, byte *out, \
+                                                       size_t nblocks)                                 \
+    {                                                                                                  \
+        vperm_decrypt_blocks_body(ctx, in, out, nblocks, nr);                                          \
+    }                                                                                                  \
+    VPERM_TARGET static void vperm_cbc_encrypt_lanes_##nr(const aes_key_ctx *const ctxs[], byte *const ivs[], \
+                                                          const byte *const in[], byte *const out[],   \
+                                                          size_t n, size_t nblocks)                    \
+    {                                                                                                  \
+        vperm_cbc_lanes_body(ctxs, ivs, in, out, n, nblocks, nr);                                      \
+    }
+
+VPERM_VARIANTS(10)
+VPERM_VARIANTS(12)
+VPERM_VARIANTS(14)
+
+static void vperm_encrypt_block(const aes_key_ctx *ctx, const byte in[16], byte out[16])
+{
+    AES_ROUNDS_DISPATCH(ctx->rounds, vperm_encrypt_block, ctx, in, out);
+}
+
+static void vperm_decrypt_block(const aes_key_ctx *ctx, const byte in[16], byte out[16])
+{
+    AES_ROUNDS_DISPATCH(ctx->rounds, vperm_decrypt_block, ctx, in, out);
+}
+
+static void vperm_encrypt_blocks(const aes_key_ctx *ctx, const byte *in, byte *out, size_t nblocks)
+{
+    AES_ROUNDS_DISPATCH(ctx->rounds, vperm_encrypt_blocks, ctx, in, out, nblocks);
+}
+
+static void vperm_decrypt_blocks(const aes_key_ctx *ctx, const byte *in, byte *out, size_t nblocks)
+{
+    AES_ROUNDS_DISPATCH(ctx->rounds, vperm_decrypt_blocks, ctx, in, out, nblocks);
+}
+
+// 分发层保证所有通道的密钥长度相同
+static void vperm_cbc_encrypt_lanes(const aes_key_ctx *const ctxs[], byte *const ivs[], const byte *const in[],
+                                    byte *const out[], size_t n, size_t nblocks)
+{
+    AES_ROUNDS_DISPATCH(ctxs[0]->rounds, vperm_cbc_encrypt_lanes, ctxs, ivs, in, out, n, nblocks);
+}
+
+// 密钥扩展借用位切片引擎的常量时间实现（SubWord 不查表）
+static void vperm_expand_key(aes_key_ctx *ctx, const byte *key, int with_dec)
+{
+    aes_engine_bitslice.expand_key(ctx, key, with_dec);
+}
+
+const struct aes_engine aes_engine_vperm = {
+    "vperm", vperm_available, vperm_expand_key, NULL,
+    vperm_encrypt_block, vperm_decrypt_block,
+    vperm_encrypt_blocks, vperm_decrypt_blocks,
+    vperm_cbc_encrypt_lanes,
+};
+
+#else
+
+// 非x86平台：引擎永远不可用，不会被选中
+static int vperm_available(void)
+{
+    return 0;
+}
+
+const struct aes_engine aes_engine_vperm = {
+    "vperm", vperm_available, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+};
+
+#endif
@@ -46,11 +46,8 @@ const byte InvSBox[256] = {
     0xa0, 0xe0, 0x3b, 0x4d, 0xae, 0x2a, 0xf5, 0xb0, 0xc8, 0xeb, 0xbb, 0x3c, 0x83, 0x53, 0x99, 0x61,
     0x17, 0x2b, 0x04, 0x7e, 0xba, 0x77, 0xd6, 0x26, 0xe1, 0x69, 0x14, 0x63, 0x55, 0x21, 0x0c, 0x7d};
 
-// 全局状态矩阵
-byte state[4][4];
-
-// 将输入数据填充到状态矩阵
-void init_state(byte input[STATE_SIZE])
+// 将输入数据填充到状态矩阵（状态矩阵由调用者提供）
+void init_state(byte state[4][4], const byte input[STATE_SIZE])
 {
     int c, r;
     for (c = 0; c < 4; c++)
@@ -99,12 +96,25 @@ void sub_word(byte *word)
     }
 }
 
-// 密钥扩展
-void key_expansion(byte key[STATE_SIZE], byte roundKeys[44][4])
+// 密钥长度（字节）对应的轮数：16/24/32 字节分别为 10/12/14 轮，其他长度返回0
+int aes_rounds_for_key(size_t key_len)
 {
+    switch (key_len)
+    {
+    case 16: return AES128_ROUNDS;
+    case 24: return AES192_ROUNDS;
+    case 32: return AES256_ROUNDS;
+    default: return 0;
+    }
+}
+
+// 密钥扩展（FIPS-197 5.2），Nk = 轮数 - 6 个字的密钥扩展为 4*(轮数+1) 个字
+void key_expansion(const byte *key, int rounds, byte roundKeys[][4])
+{
+    const int nk = rounds - 6;
     int i;
 
-    for (i = 0; i < Nk; i++)
+    for (i = 0; i < nk; i++)
     {
         roundKeys[i][0] = key[4 * i];
         roundKeys[i][1] = key[4 * i + 1];
@@ -112,7 +122,7 @@ void key_expansion(byte key[STATE_SIZE], byte roundKeys[44][4])
         roundKeys[i][3] = key[4 * i + 3];
     }
 
-    for (i = Nk; i < Nb * (Nr + 1); i++)
+    for (i = nk; i < Nb * (rounds + 1); i++)
     {
         byte temp[4];
         temp[0] = roundKeys[i - 1][0];
@@ -120,22 +130,60 @@ void key_expansion(byte key[STATE_SIZE], byte roundKeys[44][4])
         temp[2] = roundKeys[i - 1][2];
         temp[3] = roundKeys[i - 1][3];
 
-        if (i % Nk == 0)
+        if (i % nk == 0)
         {
             rot_word(temp);
             sub_word(temp);
-            temp[0] ^= Rcon[i / Nk];
+            temp[0] ^= Rcon[i / nk];
+        }
+        else if (nk > 6 && i % nk == 4)
+        {
+            sub_word(temp); // AES-256 在每组密钥字的中间多做一次 SubWord
         }
 
-        roundKeys[i][0] = roundKeys[i - Nk][0] ^ temp[0];
-        roundKeys[i][1] = roundKeys[i - Nk][1] ^ temp[1];
-        roundKeys[i][2] = roundKeys[i - Nk][2] ^ temp[2];
-        roundKeys[i][3] = roundKeys[i - Nk][3] ^ temp[3];
+        roundKeys[i][0] = roundKeys[i - nk][0] ^ temp[0];
+        roundKeys[i][1] = roundKeys[i - nk][1] ^ temp[1];
+        roundKeys[i][2] = roundKeys[i - nk][2] ^ temp[2];
+        roundKeys[i][3] = roundKeys[i - nk][3] ^ temp[3];
+    }
+}
+
+// 无分支的乘{02}，用于只应依赖密钥、不应泄漏分支的预计算
+static byte xtime_ct(byte x)
+{
+    return (byte)((x << 1) ^ ((0u - (x >> 7)) & 0x1b));
+}
+
+// 等价逆密码（FIPS-197 5.3.5）的解密轮密钥：轮密钥逆序排列，中间各轮做 InvMixColumns
+// 每个密钥上下文只计算一次，解密时每轮的结构与加密相同（InvSubBytes、InvShiftRows、InvMixColumns、AddRoundKey）
+void inv_key_expansion(const byte roundKeys[][4], byte decKeys[][4], int rounds)
+{
+    for (int round = 0; round <= rounds; round++)
+    {
+        for (int c = 0; c < Nb; c++)
+        {
+            const byte *w = roundKeys[(rounds - round) * Nb + c];
+            byte *d = decKeys[round * Nb + c];
+            if (round == 0 || round == rounds)
+            {
+                memcpy(d, w, 4);
+                continue;
+            }
+            // InvMixColumns = MixColumns ∘ P，P 对列做 a_r ^= 4·(a_r ^ a_{r+2})
+            byte u = xtime_ct(xtime_ct(w[0] ^ w[2]));
+            byte v = xtime_ct(xtime_ct(w[1] ^ w[3]));
+            byte a0 = w[0] ^ u, a1 = w[1] ^ v, a2 = w[2] ^ u, a3 = w[3] ^ v;
+            byte t = a0 ^ a1 ^ a2 ^ a3;
+            d[0] = a0 ^ t ^ xtime_ct(a0 ^ a1);
+            d[1] = a1 ^ t ^ xtime_ct(a1 ^ a2);
+            d[2] = a2 ^ t ^ xtime_ct(a2 ^ a3);
+            d[3] = a3 ^ t ^ xtime_ct(a3 ^ a0);
+        }
     }
 }
 
 // 轮密钥加操作
-void add_round_key(byte roundKeys[44][4], int round)
+void add_round_key(byte state[4][4], const byte roundKeys[][4], int round)
 {
     int c, r;
     for (c = 0; c < 4; c++)
@@ -148,7 +196,7 @@ void add_round_key(byte roundKeys[44][4], int round)
 }
 
 // 打印状态矩阵
-void print_state(void)
+void print_state(const byte state[4][4])
 {
     int i, j;
     for (i = 0; i < 4; i++)
@@ -203,6 +251,32 @@ void generate_random_iv(byte iv[16]) {
     }
 }
 
+// 16字节异或：按64位字处理，memcpy 避免非对齐访问
+void xor_block(byte *out, const byte *a, const byte *b)
+{
+    uint64_t x[2], y[2];
+    memcpy(x, a, BLOCK_SIZE);
+    memcpy(y, b, BLOCK_SIZE);
+    x[0] ^= y[0];
+    x[1] ^= y[1];
+    memcpy(out, x, BLOCK_SIZE);
+}
+
+// 任意长度异或：按64位字处理，memcpy 避免非对齐访问，不足8字节的尾部逐字节处理
+void xor_bytes(byte *out, const byte *in, const byte *ks, size_t len)
+{
+    size_t j = 0;
+    for (; j + 8 <= len; j += 8) {
+        uint64_t a, b;
+        memcpy(&a, in + j, 8);
+        memcpy(&b, ks + j, 8);
+        a ^= b;
+        memcpy(out + j, &a, 8);
+    }
+    for (; j < len; j++)
+        out[j] = in[j] ^ ks[j];
+}
+
 // 常量时间比较函数，防止时序攻击
 int ct_equal(const byte *a, const byte *b, size_t len) {
     byte diff = 0;
@@ -210,4 +284,12 @@ int ct_equal(const byte *a, const byte *b, size_t len) {
         diff |= a[i] ^ b[i];
     }
     return diff == 0;
+}
+
+// 清零之后内存不再被读取，普通 memset 可能被当作死存储删除；空的 asm 声明读取了 buf 指向的内存，
+// 编译器必须保留之前的 memset。memset 本身是按字/向量写入的，大块上下文也不必逐字节清零
+void secure_zero(void *buf, size_t len)
+{
+    memset(buf, 0, len);
+    __asm__ __volatile__("" : : "r"(buf) : "memory");
 }
\ No newline at end of file
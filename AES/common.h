@@ -9,9 +9,6 @@
 
 
 
-// 外部变量声明
-extern byte state[4][4];  //状态矩阵
-
 // S盒常量声明
 extern const byte Sbox[256];
 
@@ -22,12 +19,14 @@ extern const byte Rcon[11];
 extern const byte InvSBox[256];
 
 // 函数声明
-void init_state(byte input[STATE_SIZE]);
+void init_state(byte state[4][4], const byte input[STATE_SIZE]);
 byte xtime(byte x);
 byte mul_by_03(byte x);
-void key_expansion(byte key[STATE_SIZE], byte roundKeys[44][4]);
-void add_round_key(byte roundKeys[44][4], int round);
-void print_state(void);
+int aes_rounds_for_key(size_t key_len);
+void key_expansion(const byte *key, int rounds, byte roundKeys[][4]);
+void inv_key_expansion(const byte roundKeys[][4], byte decKeys[][4], int rounds);
+void add_round_key(byte state[4][4], const byte roundKeys[][4], int round);
+void print_state(const byte state[4][4]);
 byte mul_by_09(byte x);
 byte mul_by_0b(byte x);
 byte mul_by_0d(byte x);
@@ -35,9 +34,15 @@ byte mul_by_0e(byte x);
 void pkcs7_pad(byte *input, int input_len, byte *output, int *output_len);
 int pkcs7_unpad(byte *input, int input_len, byte *output);
 void generate_random_iv(byte iv[16]);
+void xor_block(byte *out, const byte *a, const byte *b);
+// out = in ^ ks，共 len 字节（CTR 类模式的密钥流异或），out 可与 in 相同
+void xor_bytes(byte *out, const byte *in, const byte *ks, size_t len);
 
 // 常量时间比较函数，用于HMAC验证
 int ct_equal(const byte *a, const byte *b, size_t len);
 
+// 清零密钥、密钥流等敏感数据，不会被编译器当作无用的写入删掉
+void secure_zero(void *buf, size_t len);
+
 
 #endif // COMMON_H
\ No newline at end of file
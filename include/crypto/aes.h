@@ -8,7 +8,84 @@
 extern "C" {
 #endif
 
+struct aes_engine;
+
+// Pre-expanded key context: run key_expansion once, then encrypt/decrypt many blocks.
+// Sized for the longest schedule (AES-256); `rounds` records the key size in use.
+typedef struct aes_key_ctx {
+    byte roundKeys[AES_MAX_RK_WORDS][4];  // expanded round keys (FIPS-197 byte layout)
+    uint32_t ek[AES_MAX_RK_WORDS];        // big-endian round key words for table engines
+    uint32_t dk[AES_MAX_RK_WORDS];        // decKeys as big-endian words for table engines
+    byte decKeys[AES_MAX_RK_WORDS][4];    // equivalent inverse cipher keys (FIPS-197 5.3.5): reversed,
+                                          // InvMixColumns applied; computed once at key setup
+    uint64_t bsKeys[(AES_MAX_ROUNDS + 1) * 8]; // bitsliced round keys (constant-time engine)
+    int rounds;                           // 10, 12 or 14 for AES-128/192/256
+    const struct aes_engine *engine;      // engine chosen when the key was set
+} aes_key_ctx;
+
+// AES-128 key setup (16-byte key)
+void aes_key_init(aes_key_ctx *ctx, const byte key[16]);
+// Any key size: key_len is 16, 24 or 32 bytes. Returns 0, or -1 for an invalid length.
+// Every mode that takes an aes_key_ctx (CBC, ETM, GCM) then runs AES-128/192/256 alike.
+int aes_key_setup(aes_key_ctx *ctx, const byte *key, size_t key_len);
+void aes_key_clear(aes_key_ctx *ctx);
+
+// AES engines: "aesni" (x86 AES instructions), "vperm" (constant-time SSSE3 PSHUFB
+// nibble-lookup S-box), "bitslice" (constant-time,
+// 8 blocks per pass), "ttable" (32-bit lookup tables), "ref" (byte-wise FIPS-197 reference)
+// Engines other than "ref" have a separate fully unrolled round sequence per key size,
+// so AES-256 runs exactly 14 rounds with no loop counter.
+// Without AES-NI the default is "vperm" (SSSE3) or "bitslice", so no default engine
+// does secret-dependent table lookups.
+// The default engine is picked at build time with -DAES_DEFAULT_ENGINE="name",
+// otherwise the fastest one supported by the running CPU.
+int aes_engine_select(const char *name);   // default for new contexts; 0 ok, -1 unknown/unsupported
+int aes_key_init_engine(aes_key_ctx *ctx, const byte key[16], const char *name);
+int aes_key_setup_engine(aes_key_ctx *ctx, const byte *key, size_t key_len, const char *name);
+// Encrypt-only schedule (CTR-style modes): skips the decryption round keys, so the
+// context must not be passed to any decrypt function.
+int aes_key_setup_encrypt_engine(aes_key_ctx *ctx, const byte *key, size_t key_len, const char *name);
+const char *aes_engine_name(const aes_key_ctx *ctx);
+size_t aes_engine_list(const char **names, size_t max);  // names of engines usable on this CPU
+
+void aes_encrypt_block(const aes_key_ctx *ctx, const byte input[16], byte output[16]);
+void aes_decrypt_block(const aes_key_ctx *ctx, const byte input[16], byte output[16]);
+
+// ECB over nblocks independent blocks; engines pipeline several blocks per call
+void aes_encrypt_blocks(const aes_key_ctx *ctx, const byte *input, byte *output, size_t nblocks);
+void aes_decrypt_blocks(const aes_key_ctx *ctx, const byte *input, byte *output, size_t nblocks);
+
+void aes_cbc_encrypt(const aes_key_ctx *ctx, const byte iv[16], const byte *input, byte *output, size_t length);
+void aes_cbc_decrypt(const aes_key_ctx *ctx, const byte iv[16], const byte *input, byte *output, size_t length);
+// Multi-stream CBC encryption: independent jobs (own key context, IV and buffer) are
+// interleaved so one block of each stream is in flight per AES call. Output is identical
+// to aes_cbc_encrypt on each job; job.iv is updated to the last ciphertext block.
+typedef struct aes_cbc_job {
+    const aes_key_ctx *ctx;
+    byte iv[16];
+    const byte *input;
+    byte *output;          // may equal input
+    size_t length;         // multiple of 16
+} aes_cbc_job;
+
+void aes_cbc_encrypt_multi(aes_cbc_job *jobs, size_t njobs);
+
+// CBC decryption split into independent segments across threads (each segment's IV is
+// the preceding ciphertext block). threads <= 0 uses the CPU count; segments are kept
+// large enough to amortise thread start-up. Returns the number of threads used.
+// aes_cbc_decrypt never starts threads; callers opt in by calling this explicitly.
+int aes_cbc_decrypt_parallel(const aes_key_ctx *ctx, const byte iv[16], const byte *input, byte *output, size_t length, int threads);
+
+// CTR mode (SP 800-38A): keystream block j is E(K, iv + j), the counter being the whole
+// 16-byte block as a 128-bit big-endian integer. Encryption and decryption are the same call.
+// `offset` is the byte position in the keystream where `input` starts, so any byte range of a
+// large object can be processed on its own; a whole stream is offset 0. Keystream is produced
+// for many blocks per engine call and XORed in 64-bit words; input may equal output.
+void aes_ctr_crypt(const aes_key_ctx *ctx, const byte iv[16], uint64_t offset, const byte *input, byte *output,
+                   size_t length);
+
 // Block-level AES functions (128-bit key assumed in current project)
+// Thin wrappers: expand the key into a temporary context for a single call
 void encrypt(byte key[16], byte input[16], byte output[16]);
 void decrypt(byte key[16], byte input[16], byte output[16]);
 
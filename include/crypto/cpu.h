@@ -0,0 +1,26 @@
+#ifndef CRYPTO_CPU_H
+#define CRYPTO_CPU_H
+
+// CPU 特性位，由 CPUID 在运行期检测，用于选择硬件加速实现
+#define CPU_FEATURE_SSE2   (1u << 0)
+#define CPU_FEATURE_SSSE3  (1u << 1)
+#define CPU_FEATURE_SSE41  (1u << 2)
+#define CPU_FEATURE_AESNI  (1u << 3)
+#define CPU_FEATURE_PCLMUL (1u << 4)
+#define CPU_FEATURE_AVX    (1u << 5)
+#define CPU_FEATURE_AVX2   (1u << 6)
+#define CPU_FEATURE_SHA    (1u << 7)
+#define CPU_FEATURE_BMI2   (1u << 8)
+
+// 返回当前CPU支持的特性位集合（首次调用时检测并缓存）
+unsigned crypto_cpu_features(void);
+
+// 判断是否支持给定的全部特性
+int crypto_cpu_has(unsigned features);
+
+// 硬件加速实现（gcm_clmul.c、sha256_shani.c、sha256_simd.c、sha256_mb.c 等）的共同做法：
+// 用到特殊指令的函数以 target 属性单独开启指令集，整个库不需要相应的编译选项，
+// 实现的 available 函数在运行期通过 crypto_cpu_has 决定是否使用；
+// 非 x86 平台上只编译出 available 恒为 0 的占位实现，永远不会被选中
+
+#endif // CRYPTO_CPU_H
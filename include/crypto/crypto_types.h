@@ -8,8 +8,12 @@ typedef unsigned char byte;
 
 //AES相关常量
 #define Nb 4           //列数
-#define Nk 4           //密钥长度,以32位字为单位,故当前密钥长度为128位
-#define Nr 10          //轮数
+#define AES128_ROUNDS 10 //轮数由密钥长度决定：AES-128 为10轮
+#define AES192_ROUNDS 12 //AES-192 为12轮
+#define AES256_ROUNDS 14 //AES-256 为14轮
+#define AES_MAX_ROUNDS AES256_ROUNDS  //密钥上下文按最大轮数分配
+#define AES_MAX_KEY_SIZE 32           //最长密钥（AES-256）字节数
+#define AES_MAX_RK_WORDS (Nb * (AES_MAX_ROUNDS + 1)) //轮密钥字数上限（60）
 #define STATE_SIZE 16  //状态矩阵大小
 #define BLOCK_SIZE 16  //块大小
 
@@ -3,6 +3,10 @@
 #include "crypto_types.h"
 
 int encrypt_file_HKDF(const char *input_path, const char *output_path, const char *password, size_t pass_len, size_t iterations);
+// key_len 为 16/24/32 字节（AES-128/192/256），记录在文件头中；iterations 不超过 2^24-1
+int encrypt_file_HKDF_keylen(const char *input_path, const char *output_path, const char *password, size_t pass_len,
+                             size_t iterations, size_t key_len);
+// 密钥长度从文件头读取
 int decrypt_file_HKDF(const char *input_path, const char *output_path, const char *password, size_t pass_len);
 
 #endif // FILE_CRYPTO_H
\ No newline at end of file
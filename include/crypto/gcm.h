@@ -7,10 +7,128 @@
 #define GCM_TAG_SIZE 16 // 128bit
 #define GCM_BLOCK_SIZE 16
 
+// GHASH 乘法表的索引位数：4（Shoup 4 位表，16 项共 256 字节，默认）或 8（256 项共 4KB，查表次数减半但占用更多缓存）
+#ifndef GCM_TABLE_BITS
+#define GCM_TABLE_BITS 4
+#endif
+
+#define GCM_AGG_BLOCKS 8 // CLMUL 实现每次约简前聚合的分组数，上下文保存 H^1..H^8
+
+struct gcm_ghash_impl;
+
+typedef struct gcm_u128 {
+    uint64_t hi, lo; // 大端：hi 为分组的前 8 字节
+} gcm_u128;
+
+// GCM 密钥上下文：AES 轮密钥、H = E(K, 0^128) 和 GHASH 的预计算数据只在 aes_gcm_key_init 时计算一次，
+// 同一密钥的后续消息直接复用；初始化后只读，可被多个线程同时使用
+typedef struct aes_gcm_ctx {
+    aes_key_ctx key;
+    byte H[16];
+    gcm_u128 Htable[1 << GCM_TABLE_BITS]; // Htable[i] = i·H（查表实现）
+    byte Hpow[GCM_AGG_BLOCKS][16];        // H^1..H^8，字节逆序（CLMUL 实现）
+    const struct gcm_ghash_impl *ghash;   // 初始化时选定的 GHASH 实现
+} aes_gcm_ctx;
+
+// key_len 为 16/24/32（AES-128/192/256），不支持的长度返回 -1
+// GHASH 实现运行期按 CPUID 选择：有 PCLMULQDQ 时用 "clmul"，否则用 Shoup 查表 "table"
+int aes_gcm_key_init(aes_gcm_ctx *ctx, const byte *key, size_t key_len);
+// 指定 GHASH 实现（NULL 为自动选择），名称未知或当前CPU不支持时返回 -1
+int aes_gcm_key_init_ghash(aes_gcm_ctx *ctx, const byte *key, size_t key_len, const char *ghash_name);
+const char *aes_gcm_ghash_name(const aes_gcm_ctx *ctx);
+void aes_gcm_key_clear(aes_gcm_ctx *ctx);
+
+// key 为 16 字节（AES-128）
 int aes_gcm_encrypt(const byte *key, const byte *iv, size_t iv_len, const byte *plaintext, size_t pt_len,
                     const byte *add, size_t add_len, byte *ciphertext,byte *tag);
 
+// 解密成功返回明文长度，标签不符返回 -1 且 plaintext 已被清零；ct_len 超过 INT_MAX 时不解密，直接返回 -1
 int aes_gcm_decrypt(const byte *key, const byte *iv, size_t iv_len, const byte *ciphertext, size_t ct_len,
                     const byte *aad, size_t aad_len, byte *plaintext,byte *tag);
 
+// 使用已初始化的 GCM 密钥上下文
+int aes_gcm_encrypt_ctx(const aes_gcm_ctx *ctx, const byte *iv, size_t iv_len, const byte *plaintext, size_t pt_len,
+                        const byte *aad, size_t aad_len, byte *ciphertext, byte *tag);
+
+// 返回值同 aes_gcm_decrypt
+int aes_gcm_decrypt_ctx(const aes_gcm_ctx *ctx, const byte *iv, size_t iv_len, const byte *ciphertext, size_t ct_len,
+                        const byte *aad, size_t aad_len, byte *plaintext, const byte *tag);
+
+// 先认证后解密：标签校验通过后才生成密钥流；成功返回 0，失败返回 -1 且 plaintext 完全未被写入。
+// 伪造记录的拒绝只需一遍 GHASH，适合可能遭受大量伪造数据包的场景
+int aes_gcm_verify_decrypt_ctx(const aes_gcm_ctx *ctx, const byte *iv, size_t iv_len, const byte *ciphertext,
+                               size_t ct_len, const byte *aad, size_t aad_len, byte *plaintext, const byte *tag);
+
+// 批量小记录：同一密钥下多条独立消息一次处理，各消息的计数器块（含标签用的 E(K, J0)）合并交给 AES 引擎，
+// 短消息之间也能填满流水线，并省去逐条调用的固定开销
+typedef struct aes_gcm_job {
+    const byte *iv;
+    size_t iv_len;
+    const byte *aad;
+    size_t aad_len;
+    const byte *input;
+    byte *output;          // 可与 input 相同
+    size_t length;
+    byte *tag;             // 加密时输出；解密时为待校验的标签
+    int result;            // 成功为 0，解密失败为 -1（先校验标签，失败时 output 未被写入）
+} aes_gcm_job;
+
+// 返回失败的条数，每条的结果见 jobs[i].result
+size_t aes_gcm_encrypt_batch(const aes_gcm_ctx *ctx, aes_gcm_job *jobs, size_t n);
+size_t aes_gcm_decrypt_batch(const aes_gcm_ctx *ctx, aes_gcm_job *jobs, size_t n);
+
+// 多线程 GCM：消息按分组切段，各线程从各自的计数器偏移做 CTR 并计算本段的部分 GHASH，
+// 再用 H 的幂合并，结果与串行接口逐字节相同。threads <= 0 时使用 CPU 核数；每段至少 1 MB，
+// 消息太短时退化为串行。*_ctx 一次性接口从不创建线程，需要多线程时由调用者显式使用以下接口
+int aes_gcm_encrypt_parallel(const aes_gcm_ctx *ctx, const byte *iv, size_t iv_len, const byte *plaintext,
+                             size_t pt_len, const byte *aad, size_t aad_len, byte *ciphertext, byte *tag, int threads);
+// 解密成功返回 0（明文长度即 ct_len，大消息无法用 int 表示），标签不符返回 -1 且 plaintext 已被清零
+int aes_gcm_decrypt_parallel(const aes_gcm_ctx *ctx, const byte *iv, size_t iv_len, const byte *ciphertext,
+                             size_t ct_len, const byte *aad, size_t aad_len, byte *plaintext, const byte *tag,
+                             int threads);
+
+// 流式接口：一条消息的 AAD 与数据可以分任意长度的片段送入，不需要整条消息都在内存里，
+// 结果与一次性接口逐字节相同。顺序为 init -> aad（零次或多次）-> update（零次或多次）-> final/verify，
+// 乱序调用返回 -1。单条消息的数据最多 GCM_MAX_DATA_LEN 字节（2^39 - 256 比特）
+// 注意：流式解密在 verify 之前就输出了明文，调用者必须等 verify 成功后才能使用这些数据
+#define GCM_MAX_DATA_LEN ((((uint64_t)1) << 36) - 32)
+
+typedef struct aes_gcm_stream {
+    const aes_gcm_ctx *key; // 只读引用，多条消息可同时使用同一个密钥上下文
+    byte J0[16];
+    byte ctr[16];           // 最近使用的计数器块
+    byte S[16];             // GHASH 状态
+    byte buf[16];           // 不满一块的 AAD 或密文，凑满后再做 GHASH
+    byte ks[16];            // 当前不满一块的数据所用的密钥流
+    size_t buf_len;
+    uint64_t aad_len, data_len;
+    int encrypt;
+    int phase;
+} aes_gcm_stream;
+
+// encrypt 为 1 时 update 加密，为 0 时解密；iv_len 为 0 时返回 -1
+int aes_gcm_stream_init(aes_gcm_stream *st, const aes_gcm_ctx *ctx, const byte *iv, size_t iv_len, int encrypt);
+int aes_gcm_stream_aad(aes_gcm_stream *st, const byte *aad, size_t len);
+// in 与 out 可以是同一块内存
+int aes_gcm_stream_update(aes_gcm_stream *st, const byte *in, byte *out, size_t len);
+// 加密结束，输出 16 字节标签；之后状态被清零
+int aes_gcm_stream_final(aes_gcm_stream *st, byte tag[16]);
+// 解密结束，常量时间比较标签，一致返回 0，否则返回 -1；之后状态被清零
+int aes_gcm_stream_verify(aes_gcm_stream *st, const byte tag[16]);
+
+// GMAC：只认证不加密的 GCM（明文为空，数据全部作为 AAD），与 GCM 共用密钥上下文与 GHASH 实现。
+// 同一密钥下每条消息的 IV 必须不同；iv_len 为 0 时返回 -1
+int aes_gmac_ctx(const aes_gcm_ctx *ctx, const byte *iv, size_t iv_len, const byte *data, size_t len, byte tag[16]);
+// 常量时间比较标签，一致返回 0，否则返回 -1
+int aes_gmac_verify_ctx(const aes_gcm_ctx *ctx, const byte *iv, size_t iv_len, const byte *data, size_t len,
+                        const byte tag[16]);
+
+// 流式 GMAC：init -> update（零次或多次，任意长度）-> final/verify，结果与一次性接口相同
+typedef aes_gcm_stream aes_gmac_stream;
+
+int aes_gmac_stream_init(aes_gmac_stream *st, const aes_gcm_ctx *ctx, const byte *iv, size_t iv_len);
+int aes_gmac_stream_update(aes_gmac_stream *st, const byte *data, size_t len);
+int aes_gmac_stream_final(aes_gmac_stream *st, byte tag[16]);
+int aes_gmac_stream_verify(aes_gmac_stream *st, const byte tag[16]);
+
 #endif
@@ -0,0 +1,35 @@
+#ifndef CRYPTO_GCM_SIV_H
+#define CRYPTO_GCM_SIV_H
+
+#include "crypto/gcm.h"
+
+// AES-GCM-SIV（RFC 8452）：抗 nonce 误用的 AEAD。nonce 重复时只会暴露两条消息（及 AAD）是否完全相同，
+// 不会像 GCM 那样泄露明文异或或让认证密钥失效，适合无法保证 nonce 跨重启唯一的场景
+#define GCM_SIV_NONCE_SIZE 12
+#define GCM_SIV_TAG_SIZE 16
+// 明文与 AAD 各自的上限（2^36 字节）
+#define GCM_SIV_MAX_LEN (((uint64_t)1) << 36)
+
+// 密钥上下文只保存主密钥（密钥生成密钥）的扩展结果与所选的 GHASH 实现；
+// 每条消息的认证密钥与加密密钥由 nonce 派生，POLYVAL 用同一个查表或 CLMUL 乘法核计算
+typedef struct aes_gcm_siv_ctx {
+    aes_key_ctx key;
+    const struct gcm_ghash_impl *ghash;
+} aes_gcm_siv_ctx;
+
+// key_len 为 16（AEAD_AES_128_GCM_SIV）或 32（AEAD_AES_256_GCM_SIV），其他长度返回 -1
+int aes_gcm_siv_key_init(aes_gcm_siv_ctx *ctx, const byte *key, size_t key_len);
+// ghash_name 同 aes_gcm_key_init_ghash："table"、"clmul"，NULL 为自动选择
+int aes_gcm_siv_key_init_ghash(aes_gcm_siv_ctx *ctx, const byte *key, size_t key_len, const char *ghash_name);
+void aes_gcm_siv_key_clear(aes_gcm_siv_ctx *ctx);
+
+// 加密成功返回 0，长度超限返回 -1；plaintext 与 ciphertext 可以是同一块内存
+int aes_gcm_siv_encrypt_ctx(const aes_gcm_siv_ctx *ctx, const byte nonce[GCM_SIV_NONCE_SIZE], const byte *plaintext,
+                            size_t pt_len, const byte *aad, size_t aad_len, byte *ciphertext,
+                            byte tag[GCM_SIV_TAG_SIZE]);
+// 成功返回 0（明文长度等于 ct_len）；标签不符返回 -1，此时 plaintext 已被清零
+int aes_gcm_siv_decrypt_ctx(const aes_gcm_siv_ctx *ctx, const byte nonce[GCM_SIV_NONCE_SIZE], const byte *ciphertext,
+                            size_t ct_len, const byte *aad, size_t aad_len, byte *plaintext,
+                            const byte tag[GCM_SIV_TAG_SIZE]);
+
+#endif
@@ -16,8 +16,40 @@ extern const uint32_t sha256_initial_hash[8];
 // 轮常量（素数 2,3,5,7,11,... 的立方根小数部分的前 32 位）
 extern const uint32_t sha256_round_constants[64];
 
-// 函数声明
+// 增量哈希上下文：只缓冲不足一个分组的尾部数据（至多 64 字节），消息可以分任意多段输入
+typedef struct sha256_ctx {
+    uint32_t state[8];
+    uint64_t total_len;               // 已输入的字节数
+    byte buffer[SHA256_BLOCK_SIZE];
+    size_t buffer_len;
+} sha256_ctx;
+
+void sha256_init(sha256_ctx *ctx);
+void sha256_update(sha256_ctx *ctx, const byte *data, size_t len);
+// 写出摘要并清除上下文；再次使用前需重新 sha256_init
+void sha256_final(sha256_ctx *ctx, byte digest[SHA256_HASH_SIZE]);
+
+// 一次性哈希，等价于 init + update + final，不复制输入、不分配内存
 void sha256(const byte *input, size_t input_len, byte *digest);
 void sha256_print(const byte *digest);
 
+// 多条独立消息一起哈希：每条消息占 SIMD 寄存器的一个通道（AVX2 8 条、SSE4.1 4 条），
+// 适合大量短消息（记录的 HMAC、Merkle 叶子等）；结果与逐条调用 sha256 相同
+typedef struct sha256_job {
+    const byte *data;
+    size_t len;
+    byte *digest;          // 32 字节输出
+} sha256_job;
+
+void sha256_multi(sha256_job *jobs, size_t njobs);
+
+// 压缩函数实现："shani"（SHA 扩展指令）、"avx2"、"ssse3"（SIMD 消息调度）、"scalar"（可移植 C）；
+// NULL 为自动选择，按此顺序取第一个 CPU 支持的。
+// 全局生效，供测试与基准对比各实现；名称不存在或当前 CPU 不支持时返回 -1
+int sha256_select_impl(const char *name);
+const char *sha256_impl_name(void);
+// sha256_multi 的实现："avx2"、"sse4"、"single"（逐条调用 sha256）；NULL 为自动选择，规则同上
+int sha256_multi_select_impl(const char *name);
+const char *sha256_multi_impl_name(void);
+
 #endif // CRYPTO_SHA256_H
\ No newline at end of file
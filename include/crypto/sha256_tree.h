@@ -0,0 +1,37 @@
+#ifndef CRYPTO_SHA256_TREE_H
+#define CRYPTO_SHA256_TREE_H
+
+#include "crypto/sha256.h"
+
+// SHA-256 Merkle 树摘要：数据切成固定长度的叶子（最后一个可以更短），各叶子互相独立，可以多线程并行哈希；
+// 修改某一段数据后只需重算该叶子和它到根的路径。结果与整条消息的 sha256 不同，只能与同一叶子长度的树摘要比较
+//   叶子    = SHA-256(0x00 || 叶子数据)
+//   内部节点 = SHA-256(0x01 || 左 || 右)
+// 前缀字节区分叶子与内部节点（与 RFC 6962 的 Merkle Hash Tree 相同），防止把内部节点当作叶子伪造第二原像。
+// 每层两两配对，节点数为奇数时最后一个节点原样升到上一层，树形与 RFC 6962 的划分方式一致；
+// 空数据是一个空叶子，根为 SHA-256(0x00)
+
+#define SHA256_TREE_DEFAULT_LEAF_SIZE (1024 * 1024) // 1 MB：100 GB 数据约 10 万个叶子、6 MB 节点
+
+typedef struct sha256_tree {
+    uint64_t total_len;   // 数据总长度
+    size_t leaf_size;
+    size_t leaf_count;
+    size_t node_count;    // 所有层的节点总数
+    byte (*nodes)[SHA256_HASH_SIZE]; // 逐层存放：叶子层在前，根在最后
+} sha256_tree;
+
+// 为 total_len 字节的数据建立空树（节点全零），leaf_size 为 0 时取默认值；失败返回 -1
+int sha256_tree_init(sha256_tree *tree, uint64_t total_len, size_t leaf_size);
+// 哈希从第 first_leaf 个叶子开始的 len 字节数据，并重算这些叶子到根的路径。
+// len 必须是叶子长度的整数倍，或者正好延伸到数据末尾；叶子分给 threads 个线程并行计算，threads <= 0 时使用 CPU 核数。
+// 同一个接口用于：一次交给全部数据建树、数据放不进内存时按窗口依次交给各段、某段数据修改后只更新对应叶子
+int sha256_tree_update(sha256_tree *tree, size_t first_leaf, const byte *data, size_t len, int threads);
+// 所有叶子都交给 sha256_tree_update 之后，根才是整份数据的摘要
+void sha256_tree_root(const sha256_tree *tree, byte root[SHA256_HASH_SIZE]);
+void sha256_tree_free(sha256_tree *tree);
+
+// 一次性：init + update(0, data, len) + root + free
+int sha256_tree_digest(const byte *data, size_t len, size_t leaf_size, int threads, byte root[SHA256_HASH_SIZE]);
+
+#endif // CRYPTO_SHA256_TREE_H
@@ -0,0 +1,16 @@
+#ifndef CRYPTO_THREAD_H
+#define CRYPTO_THREAD_H
+
+#include <stddef.h>
+
+// 并行任务函数，arg 指向该线程自己的参数
+typedef void (*crypto_task_fn)(void *arg);
+
+// 启动 count 个线程，第 i 个线程执行 fn((char *)args + i * arg_size)，全部结束后返回
+// 线程创建失败时该任务在当前线程中执行，因此结果总是完整的；返回0表示全部以线程方式运行
+int crypto_run_parallel(crypto_task_fn fn, void *args, size_t arg_size, int count);
+
+// 返回可用的CPU核心数（至少为1）
+int crypto_cpu_count(void);
+
+#endif // CRYPTO_THREAD_H
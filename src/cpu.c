@@ -0,0 +1,64 @@
+#include "crypto/cpu.h"
+#include <stdatomic.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+
+// 读取 XCR0，确认操作系统会保存 YMM 寄存器（AVX 需要）
+static unsigned long long read_xcr0(void)
+{
+    unsigned int eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return ((unsigned long long)edx << 32) | eax;
+}
+
+static unsigned detect_features(void)
+{
+    unsigned int eax, ebx, ecx, edx;
+    unsigned features = 0;
+
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        return 0;
+    }
+    if (edx & (1u << 26)) features |= CPU_FEATURE_SSE2;
+    if (ecx & (1u << 9))  features |= CPU_FEATURE_SSSE3;
+    if (ecx & (1u << 19)) features |= CPU_FEATURE_SSE41;
+    if (ecx & (1u << 25)) features |= CPU_FEATURE_AESNI;
+    if (ecx & (1u << 1))  features |= CPU_FEATURE_PCLMUL;
+
+    // AVX 需要 CPU 支持且 OS 通过 XSAVE 开启了 XMM/YMM 状态保存
+    int os_avx = (ecx & (1u << 27)) && ((read_xcr0() & 0x6) == 0x6);
+    if (os_avx && (ecx & (1u << 28))) features |= CPU_FEATURE_AVX;
+
+    if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+        if (os_avx && (ebx & (1u << 5))) features |= CPU_FEATURE_AVX2;
+        if (ebx & (1u << 8))  features |= CPU_FEATURE_BMI2;
+        if (ebx & (1u << 29)) features |= CPU_FEATURE_SHA;
+    }
+    return features;
+}
+#else
+static unsigned detect_features(void)
+{
+    return 0; // 非x86平台只使用可移植实现
+}
+#endif
+
+// 最高位标记已检测；多线程同时首次检测得到的是相同结果，用原子读写即可，不需要加锁
+#define CPU_FEATURES_VALID (1u << 31)
+static atomic_uint cached_features = 0;
+
+unsigned crypto_cpu_features(void)
+{
+    unsigned f = atomic_load_explicit(&cached_features, memory_order_relaxed);
+    if (!(f & CPU_FEATURES_VALID)) {
+        f = detect_features() | CPU_FEATURES_VALID;
+        atomic_store_explicit(&cached_features, f, memory_order_relaxed);
+    }
+    return f & ~CPU_FEATURES_VALID;
+}
+
+int crypto_cpu_has(unsigned features)
+{
+    return (crypto_cpu_features() & features) == features;
+}
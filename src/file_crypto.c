@@ -1,4 +1,5 @@
 // 文件格式为ITERATIONS || SALT ||（ IV || CIPHERTEXT || TAG） IV密钥TAG均在encrypt_etm函数中生成
+// ITERATIONS 为4字节大端：最高字节记录 AES 密钥长度（0 表示旧格式的 AES-128，否则为 24 或 32），低3字节为迭代次数
 #include <stdio.h>
 
 #include "crypto/file_crypto.h"
@@ -8,8 +9,19 @@
 #include "AES/common.h"
 #include "AES/AESEncryption.h"
 #include "AES/AESDecryption.h"
+#define FILE_MAX_ITERATIONS 0xFFFFFF // 迭代次数只占头部的低3字节
+
 int encrypt_file_HKDF(const char *input_path, const char *output_path, const char *password, size_t pass_len, size_t iterations)
 {
+    return encrypt_file_HKDF_keylen(input_path, output_path, password, pass_len, iterations, AES_KEY_SIZE);
+}
+
+int encrypt_file_HKDF_keylen(const char *input_path, const char *output_path, const char *password, size_t pass_len,
+                             size_t iterations, size_t key_len)
+{
+    if (aes_rounds_for_key(key_len) == 0 || iterations > FILE_MAX_ITERATIONS) {
+        return -1; // 不支持的密钥长度或迭代次数
+    }
     // 生成随机盐值
     byte salt[SALT_SIZE];
     crypto_random_bytes(salt, SALT_SIZE);
@@ -21,12 +33,12 @@ int encrypt_file_HKDF(const char *input_path, const char *output_path, const cha
 
 
     // HKDF 派生密钥
-    byte k_etm_encrypt[AES_KEY_SIZE]; // AES-ETM 加密
+    byte k_etm_encrypt[AES_MAX_KEY_SIZE]; // AES-ETM 加密，取前 key_len 字节
     byte k_etm_hmac[HMAC_KEY_SIZE];   // AES-ETM HMAC密钥
     HKDF_SHA256(master_key, MASTER_KEY_SIZE,
                 salt, SALT_SIZE,
                 (byte *)"enc_key", 7,
-                AES_KEY_SIZE,
+                key_len,
                 k_etm_encrypt);
     HKDF_SHA256(master_key, MASTER_KEY_SIZE,
                 salt, SALT_SIZE,
@@ -58,16 +70,19 @@ int encrypt_file_HKDF(const char *input_path, const char *output_path, const cha
     int max_out = input_len + BLOCK_SIZE + ETM_OVERHEAD; // 包括填充
     byte *output_buf = (byte *)malloc(max_out);
 
-    int output_len = encrypt_etm(k_etm_encrypt, k_etm_hmac, iv, input_buf, input_len, output_buf);
+    aes_key_ctx enc_ctx;
+    aes_key_setup(&enc_ctx, k_etm_encrypt, key_len);
+    int output_len = encrypt_etm_ctx(&enc_ctx, k_etm_hmac, iv, input_buf, input_len, output_buf);
+    aes_key_clear(&enc_ctx);
     if(output_len < 0){
         free(input_buf);
         free(output_buf);
         printf("Encryption failed\n");
         return -1; // 加密失败
     }
-    // 先写入迭代次数和盐值
+    // 先写入密钥长度、迭代次数和盐值
     byte iter_bytes[4]; // 大端存储
-    iter_bytes[0] = (iterations >> 24) & 0xFF;
+    iter_bytes[0] = (key_len == AES_KEY_SIZE) ? 0 : (byte)key_len; // AES-128 与旧格式完全相同
     iter_bytes[1] = (iterations >> 16) & 0xFF;
     iter_bytes[2] = (iterations >> 8) & 0xFF;
     iter_bytes[3] = iterations & 0xFF;
@@ -89,12 +104,17 @@ int decrypt_file_HKDF(const char *input_path, const char *output_path, const cha
     if(fin == NULL){
         return -1; // 文件打开失败
     }
-    // 读取迭代次数和盐值
+    // 读取密钥长度、迭代次数和盐值
     byte iter_bytes[4];
     byte salt[SALT_SIZE];
     fread(iter_bytes, 1, 4, fin);
     fread(salt, 1, SALT_SIZE, fin);
-    size_t iterations = (iter_bytes[0] << 24) | (iter_bytes[1] << 16) | (iter_bytes[2] << 8) | iter_bytes[3];
+    size_t key_len = (iter_bytes[0] == 0) ? AES_KEY_SIZE : iter_bytes[0];
+    size_t iterations = ((size_t)iter_bytes[1] << 16) | ((size_t)iter_bytes[2] << 8) | iter_bytes[3];
+    if (aes_rounds_for_key(key_len) == 0) {
+        fclose(fin);
+        return -1; // 头部记录的密钥长度无效
+    }
 
     fseek(fin, 0, SEEK_END);
     size_t file_len = ftell(fin);
@@ -112,12 +132,12 @@ int decrypt_file_HKDF(const char *input_path, const char *output_path, const cha
                        iterations, MASTER_KEY_SIZE, master_key);
     
     // HKDF 派生密钥
-    byte k_etm_encrypt[AES_KEY_SIZE]; // AES-ETM 加密
+    byte k_etm_encrypt[AES_MAX_KEY_SIZE]; // AES-ETM 加密，取前 key_len 字节
     byte k_etm_hmac[HMAC_KEY_SIZE];   // AES-ETM HMAC密钥
     HKDF_SHA256(master_key, MASTER_KEY_SIZE,
                 salt, SALT_SIZE,
                 (byte *)"enc_key", 7,
-                AES_KEY_SIZE,
+                key_len,
                 k_etm_encrypt);
     HKDF_SHA256(master_key, MASTER_KEY_SIZE,
                 salt, SALT_SIZE,
@@ -126,7 +146,10 @@ int decrypt_file_HKDF(const char *input_path, const char *output_path, const cha
                 k_etm_hmac);
 
     byte *plaintext = (byte *)malloc(etm_len); // 解密后数据不会比加密数据长
-    int plaintext_len = decrypt_etm(k_etm_encrypt, k_etm_hmac, etm_buf, etm_len, plaintext);
+    aes_key_ctx dec_ctx;
+    aes_key_setup(&dec_ctx, k_etm_encrypt, key_len);
+    int plaintext_len = decrypt_etm_ctx(&dec_ctx, k_etm_hmac, etm_buf, etm_len, plaintext);
+    aes_key_clear(&dec_ctx);
     free(etm_buf);
     if(plaintext_len < 0){
         printf("Decryption failed\n");
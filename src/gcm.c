@@ -1,69 +1,236 @@
-#include "crypto/gcm.h"
+#include "gcm_internal.h"
+#include "aes_engine.h"
+#include "crypto/thread.h"
+#include <limits.h>
+#include <stdlib.h>
 #include <string.h>
 
-// GHASH˷ʵ    οNIST SP 800-38D 6.3
-static void gcm_mult(const byte *X, const byte *Y, byte *Z)
+static uint64_t load_be64(const byte *p)
 {
-    byte V[16];
-    byte Zt[16] = {0};
+    return ((uint64_t)p[0] << 56) | ((uint64_t)p[1] << 48) | ((uint64_t)p[2] << 40) | ((uint64_t)p[3] << 32) |
+           ((uint64_t)p[4] << 24) | ((uint64_t)p[5] << 16) | ((uint64_t)p[6] << 8) | (uint64_t)p[7];
+}
 
-    memcpy(V, Y, 16);
+static void store_be64(byte *p, uint64_t v)
+{
+    for (int i = 7; i >= 0; i--, v >>= 8)
+        p[i] = (byte)v;
+}
 
-    for (int i = 0; i < 128; i++) {
-        int xi = (X[i/8] >> (7 - (i%8))) & 1;
+// V = VxGCM ıֽλ x^0 x һλ
+// Ƴ x^128  x^128 = 1 + x + x^2 + x^7 ۻأֽ 0xe1
+static void gcm_mul_x(gcm_u128 *V)
+{
+    uint64_t mask = 0 - (V->lo & 1);
+    V->lo = (V->hi << 63) | (V->lo >> 1);
+    V->hi = (V->hi >> 1) ^ (0xe100000000000000ULL & mask);
+}
+
+// GHASH˷Shoup    οNIST SP 800-38D 6.3
+// Htable[λ] = Hÿһλͳһ xϵõ
+static void gcm_init_table(gcm_u128 Htable[1 << GCM_TABLE_BITS], const byte H[16])
+{
+    const int top = 1 << (GCM_TABLE_BITS - 1);
+    gcm_u128 V;
+    V.hi = load_be64(H);
+    V.lo = load_be64(H + 8);
 
-        if (xi) {
-            for (int j = 0; j < 16; j++)
-                Zt[j] ^= V[j];
+    Htable[0].hi = Htable[0].lo = 0;
+    for (int i = top; i > 0; i >>= 1) {
+        Htable[i] = V;
+        gcm_mul_x(&V);
+    }
+    for (int i = 2; i <= top; i <<= 1) {
+        for (int j = 1; j < i; j++) {
+            Htable[i + j].hi = Htable[i].hi ^ Htable[j].hi;
+            Htable[i + j].lo = Htable[i].lo ^ Htable[j].lo;
         }
+    }
+}
 
-        int lsb = V[15] & 1;
+#if GCM_TABLE_BITS == 8
+// Z  8 λʱƳĵֽۻغԼֵ 16 λ
+static const uint16_t rem_8bit[256] = {
+    0x0000, 0x01c2, 0x0384, 0x0246, 0x0708, 0x06ca, 0x048c, 0x054e,
+    0x0e10, 0x0fd2, 0x0d94, 0x0c56, 0x0918, 0x08da, 0x0a9c, 0x0b5e,
+    0x1c20, 0x1de2, 0x1fa4, 0x1e66, 0x1b28, 0x1aea, 0x18ac, 0x196e,
+    0x1230, 0x13f2, 0x11b4, 0x1076, 0x1538, 0x14fa, 0x16bc, 0x177e,
+    0x3840, 0x3982, 0x3bc4, 0x3a06, 0x3f48, 0x3e8a, 0x3ccc, 0x3d0e,
+    0x3650, 0x3792, 0x35d4, 0x3416, 0x3158, 0x309a, 0x32dc, 0x331e,
+    0x2460, 0x25a2, 0x27e4, 0x2626, 0x2368, 0x22aa, 0x20ec, 0x212e,
+    0x2a70, 0x2bb2, 0x29f4, 0x2836, 0x2d78, 0x2cba, 0x2efc, 0x2f3e,
+    0x7080, 0x7142, 0x7304, 0x72c6, 0x7788, 0x764a, 0x740c, 0x75ce,
+    0x7e90, 0x7f52, 0x7d14, 0x7cd6, 0x7998, 0x785a, 0x7a1c, 0x7bde,
+    0x6ca0, 0x6d62, 0x6f24, 0x6ee6, 0x6ba8, 0x6a6a, 0x682c, 0x69ee,
+    0x62b0, 0x6372, 0x6134, 0x60f6, 0x65b8, 0x647a, 0x663c, 0x67fe,
+    0x48c0, 0x4902, 0x4b44, 0x4a86, 0x4fc8, 0x4e0a, 0x4c4c, 0x4d8e,
+    0x46d0, 0x4712, 0x4554, 0x4496, 0x41d8, 0x401a, 0x425c, 0x439e,
+    0x54e0, 0x5522, 0x5764, 0x56a6, 0x53e8, 0x522a, 0x506c, 0x51ae,
+    0x5af0, 0x5b32, 0x5974, 0x58b6, 0x5df8, 0x5c3a, 0x5e7c, 0x5fbe,
+    0xe100, 0xe0c2, 0xe284, 0xe346, 0xe608, 0xe7ca, 0xe58c, 0xe44e,
+    0xef10, 0xeed2, 0xec94, 0xed56, 0xe818, 0xe9da, 0xeb9c, 0xea5e,
+    0xfd20, 0xfce2, 0xfea4, 0xff66, 0xfa28, 0xfbea, 0xf9ac, 0xf86e,
+    0xf330, 0xf2f2, 0xf0b4, 0xf176, 0xf438, 0xf5fa, 0xf7bc, 0xf67e,
+    0xd940, 0xd882, 0xdac4, 0xdb06, 0xde48, 0xdf8a, 0xddcc, 0xdc0e,
+    0xd750, 0xd692, 0xd4d4, 0xd516, 0xd058, 0xd19a, 0xd3dc, 0xd21e,
+    0xc560, 0xc4a2, 0xc6e4, 0xc726, 0xc268, 0xc3aa, 0xc1ec, 0xc02e,
+    0xcb70, 0xcab2, 0xc8f4, 0xc936, 0xcc78, 0xcdba, 0xcffc, 0xce3e,
+    0x9180, 0x9042, 0x9204, 0x93c6, 0x9688, 0x974a, 0x950c, 0x94ce,
+    0x9f90, 0x9e52, 0x9c14, 0x9dd6, 0x9898, 0x995a, 0x9b1c, 0x9ade,
+    0x8da0, 0x8c62, 0x8e24, 0x8fe6, 0x8aa8, 0x8b6a, 0x892c, 0x88ee,
+    0x83b0, 0x8272, 0x8034, 0x81f6, 0x84b8, 0x857a, 0x873c, 0x86fe,
+    0xa9c0, 0xa802, 0xaa44, 0xab86, 0xaec8, 0xaf0a, 0xad4c, 0xac8e,
+    0xa7d0, 0xa612, 0xa454, 0xa596, 0xa0d8, 0xa11a, 0xa35c, 0xa29e,
+    0xb5e0, 0xb422, 0xb664, 0xb7a6, 0xb2e8, 0xb32a, 0xb16c, 0xb0ae,
+    0xbbf0, 0xba32, 0xb874, 0xb9b6, 0xbcf8, 0xbd3a, 0xbf7c, 0xbebe
+};
 
-        for (int j = 15; j > 0; j--)
-            V[j] = (V[j] >> 1) | (V[j-1] << 7);
+// Xi = XiHÿһֽڣZ = Zx^8 ^ Htable[Xi[i]]
+static void gcm_gmult(byte Xi[16], const gcm_u128 Htable[256])
+{
+    gcm_u128 Z = Htable[Xi[15]];
+    for (int i = 14; i >= 0; i--) {
+        uint64_t rem = Z.lo & 0xff;
+        Z.lo = (Z.hi << 56) | (Z.lo >> 8);
+        Z.hi = (Z.hi >> 8) ^ ((uint64_t)rem_8bit[rem] << 48);
+        Z.hi ^= Htable[Xi[i]].hi;
+        Z.lo ^= Htable[Xi[i]].lo;
+    }
+    store_be64(Xi, Z.hi);
+    store_be64(Xi + 8, Z.lo);
+}
+#else
+// Z  4 λʱƳĵͰֽۻغԼֵ 16 λ
+static const uint16_t rem_4bit[16] = {
+    0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0, 0x48c0, 0x54e0, 0xe100, 0xfd20, 0xd940, 0xc560, 0x9180, 0x8da0, 0xa9c0, 0xb5e0
+};
 
-        V[0] >>= 1;
+// Xi = XiHÿհֽڣZ = Zx^4 ^ Htable[nibble]
+// ԭλʵÿҪ 128  16 ֽλֻ 32 β
+static void gcm_gmult(byte Xi[16], const gcm_u128 Htable[16])
+{
+    gcm_u128 Z = Htable[Xi[15] & 0xf];
+    int i = 15, hi_nibble = 1; // һҪյ Xi[15] ĸֽ߰
+    while (i >= 0) {
+        int n;
+        if (hi_nibble) {
+            n = Xi[i--] >> 4;
+        } else {
+            n = Xi[i] & 0xf;
+        }
+        hi_nibble = !hi_nibble;
 
-        if (lsb)
-            V[0] ^= 0xe1;
+        uint64_t rem = Z.lo & 0xf;
+        Z.lo = (Z.hi << 60) | (Z.lo >> 4);
+        Z.hi = (Z.hi >> 4) ^ ((uint64_t)rem_4bit[rem] << 48);
+        Z.hi ^= Htable[n].hi;
+        Z.lo ^= Htable[n].lo;
     }
+    store_be64(Xi, Z.hi);
+    store_be64(Xi + 8, Z.lo);
+}
+#endif
 
-    memcpy(Z, Zt, 16);
+static void table_init(aes_gcm_ctx *ctx)
+{
+    gcm_init_table(ctx->Htable, ctx->H);
 }
 
-// GHASH     οNIST SP 800-38D 6.4
-static void ghash(const byte *H, const byte *X, size_t len, byte *Y)
+static void table_ghash(const aes_gcm_ctx *ctx, byte Y[16], const byte *X, size_t len)
 {
-    byte Xi[16];
     for (size_t i = 0; i < len; i += 16) // Կд
     {
         size_t block_len = (len - i < 16) ? (len - i) : 16;
-        // step 2
-        memset(Xi, 0, 16);
-        memcpy(Xi, X + i, block_len);
-        for (int j = 0; j < 16; j++)
-            Y[j] ^= Xi[j];
-        gcm_mult(Y, H, Y);
+        // step 2һĲְ㴦
+        for (size_t j = 0; j < block_len; j++)
+            Y[j] ^= X[i + j];
+        gcm_gmult(Y, ctx->Htable);
+    }
+}
+
+const struct gcm_ghash_impl gcm_ghash_table = {
+    "table", NULL, table_init, table_ghash, NULL, NULL,
+};
+
+// ȼУaes_gcm_key_init ѡһõ
+static const struct gcm_ghash_impl *const ghash_impls[] = {
+    &gcm_ghash_clmul,
+    &gcm_ghash_table,
+};
+
+static int ghash_impl_usable(const struct gcm_ghash_impl *impl)
+{
+    return impl->available == NULL || impl->available();
+}
+
+static const struct gcm_ghash_impl *ghash_impl_find(const char *name)
+{
+    for (size_t i = 0; i < sizeof(ghash_impls) / sizeof(ghash_impls[0]); i++) {
+        if (name == NULL ? ghash_impl_usable(ghash_impls[i]) : strcmp(ghash_impls[i]->name, name) == 0)
+            return ghash_impls[i];
     }
+    return NULL;
 }
 
-// inc_32  4 ֽڣ32 λִ޷ 1 
-static void inc_32(byte *counter)
+const struct gcm_ghash_impl *gcm_ghash_select(const char *name)
 {
-    uint32_t n = ((uint32_t)counter[12] << 24) |
-                 ((uint32_t)counter[13] << 16) |
-                 ((uint32_t)counter[14] << 8) | counter[15];
-    n++;
-    counter[12] = (n >> 24) & 0xFF;
-    counter[13] = (n >> 16) & 0xFF;
-    counter[14] = (n >> 8) & 0xFF;
-    counter[15] = n & 0xFF;
+    const struct gcm_ghash_impl *impl = ghash_impl_find(name);
+    return (impl != NULL && ghash_impl_usable(impl)) ? impl : NULL;
+}
+
+// GHASH     οNIST SP 800-38D 6.4
+static void ghash(const aes_gcm_ctx *ctx, const byte *X, size_t len, byte *Y)
+{
+    ctx->ghash->ghash(ctx, Y, X, len);
+}
+
+// ԿģAES ԿչH = E(K, 0^128) ˷ H ݣֻһ
+int aes_gcm_key_init_ghash(aes_gcm_ctx *ctx, const byte *key, size_t key_len, const char *ghash_name)
+{
+    const struct gcm_ghash_impl *impl = gcm_ghash_select(ghash_name);
+    if (impl == NULL)
+        return -1;
+    if (aes_key_setup(&ctx->key, key, key_len) != 0)
+        return -1;
+    memset(ctx->H, 0, 16);
+    aes_encrypt_block(&ctx->key, ctx->H, ctx->H); // step 1
+    ctx->ghash = impl;
+    impl->init(ctx);
+    return 0;
+}
+
+int aes_gcm_key_init(aes_gcm_ctx *ctx, const byte *key, size_t key_len)
+{
+    return aes_gcm_key_init_ghash(ctx, key, key_len, NULL);
+}
+
+const char *aes_gcm_ghash_name(const aes_gcm_ctx *ctx)
+{
+    return ctx->ghash->name;
+}
+
+void aes_gcm_key_clear(aes_gcm_ctx *ctx)
+{
+    secure_zero(ctx, sizeof(*ctx)); // H ˷ͬԿ
+}
+
+static uint32_t load_be32(const byte *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static void store_be32(byte *p, uint32_t v)
+{
+    p[0] = (byte)(v >> 24);
+    p[1] = (byte)(v >> 16);
+    p[2] = (byte)(v >> 8);
+    p[3] = (byte)v;
 }
 
 // ʼ J0NIST SP 800-38D 7.1
 //  96 λ IV, J0 = IV || 0^31 || 1.
 // ȵ IV, J0 = GHASH(H, IV || pad || [len(IV)]), where len(IV) is in bits.
-static void compute_J0(const byte *H, const byte *iv, size_t iv_len, byte *J0)
+static void compute_J0(const aes_gcm_ctx *ctx, const byte *iv, size_t iv_len, byte *J0)
 {
     if (iv_len == 12) {
         memcpy(J0, iv, 12);
@@ -73,115 +240,590 @@ static void compute_J0(const byte *H, const byte *iv, size_t iv_len, byte *J0)
     }
 
     memset(J0, 0, 16);
-    ghash(H, iv, iv_len, J0);
+    ghash(ctx, iv, iv_len, J0);
 
     byte len_block[16] = {0};
     uint64_t iv_bits = (uint64_t)iv_len * 8;
     for (int i = 0; i < 8; i++)
         len_block[i] = (iv_bits >> (56 - i * 8)) & 0xFF;
 
-    ghash(H, len_block, 16, J0);
+    ghash(ctx, len_block, 16, J0);
 }
 
-// gctr     οNIST SP 800-38D 6.5
-static void gctr(const byte *key, byte *ICB, const byte *in, size_t len, byte *out)
+// len(A) || len(C)Ϊ 64 λ
+static void gcm_len_block(byte block[16], size_t aad_len, size_t len)
 {
-    byte counter[16], keystream[16];
-    memcpy(counter, ICB, 16); // Ƶcounter
-    size_t i = 0;
-    while (i < len)
+    uint64_t a_bits = (uint64_t)aad_len * 8, c_bits = (uint64_t)len * 8;
+    for (int i = 0; i < 8; i++) {
+        block[i] = (a_bits >> (56 - i * 8)) & 0xFF;
+        block[8 + i] = (c_bits >> (56 - i * 8)) & 0xFF;
+    }
+}
+
+// ϵ GCTR + GHASH     οNIST SP 800-38D 6.56.4
+// ԭʵȶϢ GCTRٰĴͷһ GHASHϢҪ棻
+// ÿ GCTR_BATCH Կ GHASHֻһ
+// ctr Ϊǰ飨ÿʹǰ inc_32ʱ£S Ϊ GHASH ״̬Ϊ NULL ʱֻ GCTR
+// ʱ GHASHʱ GHASH֧ԭؽܣ
+#define GCTR_BATCH 8
+static void gcm_crypt(const aes_gcm_ctx *ctx, byte ctr[16], const byte *in, byte *out, size_t len, byte S[16],
+                      int encrypt)
+{
+    // AES-NI + CLMUL ʱֽӲϺˣAES  CLMUL ͬһѭｻ
+    if (S != NULL && len >= GCTR_BATCH * 16 && ctx->ghash->crypt_aesni != NULL &&
+        ctx->key.engine == &aes_engine_aesni) {
+        size_t done = ctx->ghash->crypt_aesni(ctx, ctr, in, out, len, S, encrypt);
+        in += done;
+        out += done;
+        len -= done;
+    }
+
+    byte counters[GCTR_BATCH * 16], keystream[GCTR_BATCH * 16];
+    uint32_t c = load_be32(ctr + 12);
+    for (int b = 0; b < GCTR_BATCH; b++)
+        memcpy(counters + b * 16, ctr, 12);
+    while (len > 0)
     {
-        inc_32(counter);                          // ͬstep 5
-        encrypt((byte *)key, counter, keystream); // AES
-        size_t block = (len - i < 16) ? (len - i) : 16;
-        for (size_t j = 0; j < block; j++)
-        {
-            out[i + j] = in[i + j] ^ keystream[j]; // ͬstep 6֮Ĳ
+        size_t chunk = (len < sizeof(keystream)) ? len : sizeof(keystream);
+        size_t nblocks = (chunk + 15) / 16;
+        for (size_t b = 0; b < nblocks; b++)
+            store_be32(counters + b * 16 + 12, ++c); // inc_32ͬstep 5
+        aes_encrypt_blocks(&ctx->key, counters, keystream, nblocks); // AESһˮ
+        if (S != NULL && !encrypt)
+            ghash(ctx, in, chunk, S);
+        xor_bytes(out, in, keystream, chunk); // ͬstep 6֮Ĳ
+        if (S != NULL && encrypt)
+            ghash(ctx, out, chunk, S); // ֻһܲһ飬GHASH 
+        in += chunk;
+        out += chunk;
+        len -= chunk;
+    }
+    store_be32(ctr + 12, c);
+    secure_zero(keystream, sizeof(keystream)); // Կͬ
+}
+
+// ʽӿ    οNIST SP 800-38D 7
+// AAD ݶԷⳤȵƬ룺һ AAD ݴ buf У 16 ֽ GHASH
+// һõԿ ks Уһεô ks[buf_len] 鲿ֱӽ gcm_crypt
+#define GCM_PHASE_AAD 0
+#define GCM_PHASE_DATA 1
+#define GCM_PHASE_DONE 2
+
+int aes_gcm_stream_init(aes_gcm_stream *st, const aes_gcm_ctx *ctx, const byte *iv, size_t iv_len, int encrypt)
+{
+    if (iv_len == 0) // NIST Ҫ 1 <= len(IV)
+        return -1;
+    memset(st, 0, sizeof(*st));
+    st->key = ctx;
+    st->encrypt = encrypt;
+    st->phase = GCM_PHASE_AAD;
+    compute_J0(ctx, iv, iv_len, st->J0);
+    memcpy(st->ctr, st->J0, 16);
+    return 0;
+}
+
+int aes_gcm_stream_aad(aes_gcm_stream *st, const byte *aad, size_t len)
+{
+    if (st->phase != GCM_PHASE_AAD)
+        return -1; // AAD ֮ǰ
+    if (len == 0)
+        return 0;
+    st->aad_len += len;
+    if (st->buf_len > 0) {
+        size_t n = (16 - st->buf_len < len) ? 16 - st->buf_len : len;
+        memcpy(st->buf + st->buf_len, aad, n);
+        st->buf_len += n;
+        aad += n;
+        len -= n;
+        if (st->buf_len < 16)
+            return 0;
+        ghash(st->key, st->buf, 16, st->S);
+        st->buf_len = 0;
+    }
+    size_t full = len & ~(size_t)15;
+    if (full > 0)
+        ghash(st->key, aad, full, st->S);
+    memcpy(st->buf, aad + full, len - full);
+    st->buf_len = len - full;
+    return 0;
+}
+
+// AAD һ AAD 
+static void gcm_stream_end_aad(aes_gcm_stream *st)
+{
+    if (st->buf_len > 0)
+        ghash(st->key, st->buf, st->buf_len, st->S);
+    st->buf_len = 0;
+    st->phase = GCM_PHASE_DATA;
+}
+
+int aes_gcm_stream_update(aes_gcm_stream *st, const byte *in, byte *out, size_t len)
+{
+    const aes_gcm_ctx *ctx = st->key;
+    if (st->phase == GCM_PHASE_DONE || len > GCM_MAX_DATA_LEN - st->data_len)
+        return -1;
+    if (st->phase == GCM_PHASE_AAD)
+        gcm_stream_end_aad(st);
+    st->data_len += len;
+
+    // ȲϴµĲһķ
+    if (st->buf_len > 0) {
+        while (len > 0 && st->buf_len < 16) {
+            byte x = *in++;
+            byte y = x ^ st->ks[st->buf_len];
+            st->buf[st->buf_len++] = st->encrypt ? y : x; // GHASH 
+            *out++ = y;
+            len--;
         }
-        i += block;
+        if (st->buf_len < 16)
+            return 0;
+        ghash(ctx, st->buf, 16, st->S);
+        st->buf_len = 0;
     }
+
+    size_t full = len & ~(size_t)15;
+    if (full > 0) {
+        gcm_crypt(ctx, st->ctr, in, out, full, st->S, st->encrypt);
+        in += full;
+        out += full;
+        len -= full;
+    }
+
+    if (len > 0) {
+        store_be32(st->ctr + 12, load_be32(st->ctr + 12) + 1); // inc_32
+        aes_encrypt_block(&ctx->key, st->ctr, st->ks);
+        for (size_t j = 0; j < len; j++) {
+            st->buf[j] = st->encrypt ? (byte)(in[j] ^ st->ks[j]) : in[j]; // GHASH 
+            out[j] = in[j] ^ st->ks[j];
+        }
+        st->buf_len = len;
+    }
+    return 0;
 }
 
-// ܺ    οNIST SP 800-38D 7
-int aes_gcm_encrypt(const byte *key, const byte *iv, size_t iv_len,
-                    const byte *plaintext, size_t pt_len,
-                    const byte *aad, size_t aad_len,
-                    byte *ciphertext, byte *tag)
+// T = MSB_128( E(K, J0)  GHASH(H, A || C || len) )
+static int gcm_stream_tag(aes_gcm_stream *st, byte tag[16])
 {
-    // step 1
-    byte H[16] = {0}, J0[16] = {0}, S[16] = {0};
-    encrypt((byte *)key, H, H); // H = E(K, 0^128)
+    if (st->phase == GCM_PHASE_DONE)
+        return -1;
+    if (st->phase == GCM_PHASE_AAD)
+        gcm_stream_end_aad(st);
+    if (st->buf_len > 0)
+        ghash(st->key, st->buf, st->buf_len, st->S);
 
-    // J0 㣨NIST 7.1
-    compute_J0(H, iv, iv_len, J0);
+    byte len_block[16], E_J0[16];
+    gcm_len_block(len_block, st->aad_len, st->data_len);
+    ghash(st->key, len_block, 16, st->S);
+    aes_encrypt_block(&st->key->key, st->J0, E_J0);
+    for (int i = 0; i < 16; i++)
+        tag[i] = E_J0[i] ^ st->S[i];
+    return 0;
+}
 
-    //   step 3
-    gctr(key, J0, plaintext, pt_len, ciphertext); // C = GCTR(K, J0, P)
+int aes_gcm_stream_final(aes_gcm_stream *st, byte tag[16])
+{
+    int ret = gcm_stream_tag(st, tag);
+    secure_zero(st, sizeof(*st));
+    st->phase = GCM_PHASE_DONE;
+    return ret;
+}
 
-    // GHASH(A || C || len)
-    byte len_block[16];
-    uint64_t a_bits = aad_len * 8, c_bits = pt_len * 8;
-    for (int i = 0; i < 8; i++)
-    {
-        len_block[i] = (a_bits >> (56 - i * 8)) & 0xFF;
-        len_block[8 + i] = (c_bits >> (56 - i * 8)) & 0xFF;
+int aes_gcm_stream_verify(aes_gcm_stream *st, const byte tag[16])
+{
+    byte expected_tag[16];
+    int ret = gcm_stream_tag(st, expected_tag);
+    secure_zero(st, sizeof(*st));
+    st->phase = GCM_PHASE_DONE;
+    // ʱȽϣʱ򹥻
+    if (ret != 0 || !ct_equal(tag, expected_tag, GCM_TAG_SIZE))
+        return -1;
+    return 0;
+}
+
+// ߳ GCM
+// ϢгɶΣÿδԼļƫƿʼ GCTR 0 ʼ㱾ĵ GHASHֵ P_t
+// GHASH  Horner ʽ Y = (...((X_1H ^ X_2)H ^ ...)HϢֵ԰κϲ
+// Y = YH^(n_t) ^ P_tn_t Ϊ t εķ봮мֽͬ
+// ÿ߳ٴķ̫Сķֶ߳̿
+#define GCM_SEGMENT_MIN_BLOCKS (64 * 1024)
+
+// Ԫصĳ˷λֻںϲֶʱ H^n٣
+static gcm_u128 gcm_gf_mult(gcm_u128 X, gcm_u128 V)
+{
+    gcm_u128 Z = { 0, 0 };
+    for (int i = 0; i < 128; i++) {
+        uint64_t mask = 0 - ((i < 64 ? X.hi >> (63 - i) : X.lo >> (127 - i)) & 1);
+        Z.hi ^= V.hi & mask;
+        Z.lo ^= V.lo & mask;
+        gcm_mul_x(&V);
+    }
+    return Z;
+}
+
+// H^nƽ-˷˷λԪ x^0λ
+static gcm_u128 gcm_h_pow(const aes_gcm_ctx *ctx, uint64_t n)
+{
+    gcm_u128 R = { 0x8000000000000000ULL, 0 }, P;
+    P.hi = load_be64(ctx->H);
+    P.lo = load_be64(ctx->H + 8);
+    for (; n > 0; n >>= 1) {
+        if (n & 1)
+            R = gcm_gf_mult(R, P);
+        P = gcm_gf_mult(P, P);
+    }
+    return R;
+}
+
+struct gcm_segment {
+    const aes_gcm_ctx *ctx;
+    byte ctr[16];        // εһ֮ǰļ
+    const byte *input;
+    byte *output;
+    size_t length;       // һⶼ 16 ı
+    byte S[16];          // ĵĲ GHASH
+    int encrypt;
+};
+
+static void gcm_segment_task(void *arg)
+{
+    struct gcm_segment *seg = (struct gcm_segment *)arg;
+    memset(seg->S, 0, 16);
+    gcm_crypt(seg->ctx, seg->ctr, seg->input, seg->output, seg->length, seg->S, seg->encrypt);
+}
+
+// ӽܶõıǩܵıȽɵ
+// а汾һԽӿھʽӿڵĵεãߵֽͬ
+static int gcm_crypt_serial(const aes_gcm_ctx *ctx, const byte *iv, size_t iv_len, const byte *in, size_t len,
+                            const byte *aad, size_t aad_len, byte *out, byte tag[16], int encrypt)
+{
+    aes_gcm_stream st;
+    if (aes_gcm_stream_init(&st, ctx, iv, iv_len, encrypt) != 0 ||
+        aes_gcm_stream_aad(&st, aad, aad_len) != 0 ||
+        aes_gcm_stream_update(&st, in, out, len) != 0) {
+        secure_zero(&st, sizeof(st));
+        return -1;
+    }
+    return aes_gcm_stream_final(&st, tag);
+}
+
+static int gcm_crypt_parallel(const aes_gcm_ctx *ctx, const byte *iv, size_t iv_len, const byte *in, size_t len,
+                              const byte *aad, size_t aad_len, byte *out, byte tag[16], int encrypt, int threads)
+{
+    size_t full_blocks = len / 16;
+    if (iv_len == 0 || (uint64_t)len > GCM_MAX_DATA_LEN)
+        return -1;
+    if (threads <= 0)
+        threads = crypto_cpu_count();
+    if ((size_t)threads > full_blocks / GCM_SEGMENT_MIN_BLOCKS)
+        threads = (int)(full_blocks / GCM_SEGMENT_MIN_BLOCKS);
+    if (threads <= 1)
+        return gcm_crypt_serial(ctx, iv, iv_len, in, len, aad, aad_len, out, tag, encrypt);
+
+    struct gcm_segment *segs = (struct gcm_segment *)malloc(sizeof(struct gcm_segment) * threads);
+    if (segs == NULL)
+        return gcm_crypt_serial(ctx, iv, iv_len, in, len, aad, aad_len, out, tag, encrypt);
+
+    byte J0[16], S[16] = {0};
+    compute_J0(ctx, iv, iv_len, J0);
+    uint32_t c0 = load_be32(J0 + 12);
+    size_t per = full_blocks / threads;
+    size_t first = 0;
+    for (int t = 0; t < threads; t++) {
+        size_t n = (t == threads - 1) ? (len + 15) / 16 - first : per;
+        segs[t].ctx = ctx;
+        memcpy(segs[t].ctr, J0, 16);
+        store_be32(segs[t].ctr + 12, c0 + (uint32_t)first); // inc_32  first Σ 2^32 
+        segs[t].input = in + first * 16;
+        segs[t].output = out + first * 16;
+        segs[t].length = (t == threads - 1) ? len - first * 16 : n * 16;
+        segs[t].encrypt = encrypt;
+        first += n;
     }
+    crypto_run_parallel(gcm_segment_task, segs, sizeof(struct gcm_segment), threads);
 
-    // S = GHASH(H, A || C || len)
-    memset(S, 0, 16);
+    // Y = GHASH(A)Ȼ Y = YH^(n_t) ^ P_tǰηͬH^per ֻһ
     if (aad_len > 0)
-        ghash(H, aad, aad_len, S);
-    if (pt_len > 0)
-        ghash(H, ciphertext, pt_len, S);
-    ghash(H, len_block, 16, S);
-
-    // T = MSB_128( E(K, J0)  S )  (E(K, J0), not GCTR)
-    byte E_J0[16];
-    encrypt((byte *)key, J0, E_J0);
+        ghash(ctx, aad, aad_len, S);
+    gcm_u128 Hper = gcm_h_pow(ctx, per);
+    for (int t = 0; t < threads; t++) {
+        gcm_u128 Y, Hn = (t == threads - 1) ? gcm_h_pow(ctx, (segs[t].length + 15) / 16) : Hper;
+        Y.hi = load_be64(S);
+        Y.lo = load_be64(S + 8);
+        Y = gcm_gf_mult(Y, Hn);
+        store_be64(S, Y.hi);
+        store_be64(S + 8, Y.lo);
+        for (int i = 0; i < 16; i++)
+            S[i] ^= segs[t].S[i];
+    }
+    free(segs);
+
+    byte len_block[16], E_J0[16];
+    gcm_len_block(len_block, aad_len, len);
+    ghash(ctx, len_block, 16, S);
+    aes_encrypt_block(&ctx->key, J0, E_J0);
     for (int i = 0; i < 16; i++)
         tag[i] = E_J0[i] ^ S[i];
+    return 0;
+}
 
+// ʱȽϣʱ򹥻ʧʱģɹ 0
+static int gcm_check_tag(int ret, const byte *tag, const byte expected_tag[16], byte *plaintext, size_t ct_len)
+{
+    if (ret != 0 || !ct_equal(tag, expected_tag, GCM_TAG_SIZE)) {
+        memset(plaintext, 0, ct_len);   // ȫֹй¶
+        return -1;  // CRYPTO_ERR_MAC
+    }
     return 0;
 }
 
+int aes_gcm_encrypt_parallel(const aes_gcm_ctx *ctx, const byte *iv, size_t iv_len, const byte *plaintext,
+                             size_t pt_len, const byte *aad, size_t aad_len, byte *ciphertext, byte *tag, int threads)
+{
+    return gcm_crypt_parallel(ctx, iv, iv_len, plaintext, pt_len, aad, aad_len, ciphertext, tag, 1, threads);
+}
+
+int aes_gcm_decrypt_parallel(const aes_gcm_ctx *ctx, const byte *iv, size_t iv_len, const byte *ciphertext,
+                             size_t ct_len, const byte *aad, size_t aad_len, byte *plaintext, const byte *tag,
+                             int threads)
+{
+    byte expected_tag[16];
+    int ret = gcm_crypt_parallel(ctx, iv, iv_len, ciphertext, ct_len, aad, aad_len, plaintext, expected_tag, 0,
+                                 threads);
+    return gcm_check_tag(ret, tag, expected_tag, plaintext, ct_len);
+}
+
+// ܺ    οNIST SP 800-38D 7
+// ԿľAES-128/192/256step 1  H  aes_gcm_key_init 
+// ʼڵ߳ɣֻ߳ڵʽʹ aes_gcm_encrypt_parallel ʱ
+int aes_gcm_encrypt_ctx(const aes_gcm_ctx *ctx, const byte *iv, size_t iv_len,
+                        const byte *plaintext, size_t pt_len,
+                        const byte *aad, size_t aad_len,
+                        byte *ciphertext, byte *tag)
+{
+    return gcm_crypt_serial(ctx, iv, iv_len, plaintext, pt_len, aad, aad_len, ciphertext, tag, 1);
+}
+
+// AES-128 ӿڣÿεʱԿģͬһԿϢʱӦ aes_gcm_key_init + *_ctx
+int aes_gcm_encrypt(const byte *key, const byte *iv, size_t iv_len,
+                    const byte *plaintext, size_t pt_len,
+                    const byte *aad, size_t aad_len,
+                    byte *ciphertext, byte *tag)
+{
+    aes_gcm_ctx ctx;
+    if (aes_gcm_key_init(&ctx, key, 16) != 0) {
+        aes_gcm_key_clear(&ctx);
+        return -1;
+    }
+    int ret = aes_gcm_encrypt_ctx(&ctx, iv, iv_len, plaintext, pt_len, aad, aad_len, ciphertext, tag);
+    aes_gcm_key_clear(&ctx);
+    return ret;
+}
+
 // ܺ Ӧ㷨5
-int aes_gcm_decrypt(const byte *key, const byte *iv, size_t iv_len, const byte *ciphertext, size_t ct_len,
-                    const byte *aad, size_t aad_len, byte *plaintext, byte *tag)
+int aes_gcm_decrypt_ctx(const aes_gcm_ctx *ctx, const byte *iv, size_t iv_len, const byte *ciphertext, size_t ct_len,
+                        const byte *aad, size_t aad_len, byte *plaintext, const byte *tag)
 {
     // ct_len is plaintext length; it can be zero.
-    byte H[16] = {0}, J0[16] = {0}, len_block[16], S[16] = {0};
-    // step 2
-    encrypt((byte *)key, H, H);
-    // step 3
-    compute_J0(H, iv, iv_len, J0);
-    // step 4
-    gctr(key, J0, ciphertext, ct_len, plaintext);
-
-    uint64_t a_bits = (uint64_t)aad_len * 8;
-    uint64_t c_bits = (uint64_t)ct_len * 8;
-    for (int i = 0; i < 8; i++) {
-        len_block[i]   = (a_bits >> (56 - i*8)) & 0xFF;
-        len_block[8+i] = (c_bits >> (56 - i*8)) & 0xFF;
-    }
+    byte expected_tag[16];
+    if (ct_len > INT_MAX)
+        return -1;  // ɹʱ (int)ct_lenϢ޷ʾǰֱӾܾ
+    int ret = gcm_crypt_serial(ctx, iv, iv_len, ciphertext, ct_len, aad, aad_len, plaintext, expected_tag, 0);
+    if (gcm_check_tag(ret, tag, expected_tag, plaintext, ct_len) != 0)
+        return -1;
+    return (int)ct_len;  // ɹĳ
+}
 
-    // S = GHASH(H, A || C || len)
-    memset(S, 0, 16);
+// ֻǩݣT = E(K, J0)  GHASH(H, A || C || len)
+static void gcm_auth_tag(const aes_gcm_ctx *ctx, const byte J0[16], const byte *aad, size_t aad_len,
+                         const byte *ciphertext, size_t ct_len, byte tag[16])
+{
+    byte S[16] = {0}, len_block[16], E_J0[16];
     if (aad_len > 0)
-        ghash(H, aad, aad_len, S);
+        ghash(ctx, aad, aad_len, S);
     if (ct_len > 0)
-        ghash(H, ciphertext, ct_len, S);
-    ghash(H, len_block, 16, S);
-
-    byte expected_tag[16];
-    byte E_J0[16];
-    encrypt((byte *)key, J0, E_J0);
+        ghash(ctx, ciphertext, ct_len, S);
+    gcm_len_block(len_block, aad_len, ct_len);
+    ghash(ctx, len_block, 16, S);
+    aes_encrypt_block(&ctx->key, J0, E_J0);
     for (int i = 0; i < 16; i++)
-        expected_tag[i] = E_J0[i] ^ S[i];
+        tag[i] = E_J0[i] ^ S[i];
+}
 
-    // ʱȽϣʱ򹥻ʹĿ ct_equal
-    if (!ct_equal(tag, expected_tag, GCM_TAG_SIZE)) {
-        memset(plaintext, 0, ct_len);   // ȫֹй¶
+// ֤ܣGHASH(A || C || len)  E(K, J0) ǩȽϣһºԿܡ
+// αļ¼ֻһ GHASH ͱܾҲҪplaintext δд룩
+// Ϸ¼ҪģϢȷϵ aes_gcm_decrypt_ctx ʺ϶̼¼αĳ
+int aes_gcm_verify_decrypt_ctx(const aes_gcm_ctx *ctx, const byte *iv, size_t iv_len, const byte *ciphertext,
+                               size_t ct_len, const byte *aad, size_t aad_len, byte *plaintext, const byte *tag)
+{
+    byte J0[16], ctr[16], expected_tag[16];
+    if (iv_len == 0 || (uint64_t)ct_len > GCM_MAX_DATA_LEN)
+        return -1;
+
+    compute_J0(ctx, iv, iv_len, J0);
+    gcm_auth_tag(ctx, J0, aad, aad_len, ciphertext, ct_len, expected_tag);
+    if (!ct_equal(tag, expected_tag, GCM_TAG_SIZE))
         return -1;  // CRYPTO_ERR_MAC
+
+    memcpy(ctr, J0, 16);
+    gcm_crypt(ctx, ctr, ciphertext, plaintext, ct_len, NULL, 0);
+    return 0;
+}
+
+// GMAC    οNIST SP 800-38D 3Ϊյ GCM֤ȫΪ AAD
+// ÿϢֻһ E(K, J0)ȫ GHASHCLMUL ʵ½ӽ GHASH 
+int aes_gmac_ctx(const aes_gcm_ctx *ctx, const byte *iv, size_t iv_len, const byte *data, size_t len, byte tag[16])
+{
+    byte J0[16];
+    if (iv_len == 0)
+        return -1;
+    compute_J0(ctx, iv, iv_len, J0);
+    gcm_auth_tag(ctx, J0, data, len, NULL, 0, tag);
+    return 0;
+}
+
+int aes_gmac_verify_ctx(const aes_gcm_ctx *ctx, const byte *iv, size_t iv_len, const byte *data, size_t len,
+                        const byte tag[16])
+{
+    byte expected_tag[16];
+    if (aes_gmac_ctx(ctx, iv, iv_len, data, len, expected_tag) != 0)
+        return -1;
+    // ʱȽϣʱ򹥻
+    return ct_equal(tag, expected_tag, GCM_TAG_SIZE) ? 0 : -1;
+}
+
+// ʽ GMAC ֻ AAD  GCM 
+int aes_gmac_stream_init(aes_gmac_stream *st, const aes_gcm_ctx *ctx, const byte *iv, size_t iv_len)
+{
+    return aes_gcm_stream_init(st, ctx, iv, iv_len, 1);
+}
+
+int aes_gmac_stream_update(aes_gmac_stream *st, const byte *data, size_t len)
+{
+    return aes_gcm_stream_aad(st, data, len);
+}
+
+int aes_gmac_stream_final(aes_gmac_stream *st, byte tag[16])
+{
+    return aes_gcm_stream_final(st, tag);
+}
+
+int aes_gmac_stream_verify(aes_gmac_stream *st, const byte tag[16])
+{
+    return aes_gcm_stream_verify(st, tag);
+}
+
+// С¼    ͬһԿµĶϢ
+// Ϣʱ̶״̬ʼ E(K, J0)һ AES ãռ˴ͷϢ
+// J0ڱǩȫƴͬһһν aes_encrypt_blocksͬϢķｻˮ
+// ֮ GHASHʱȱȽϱǩʧܵļ¼дͳĳϢͨ·
+#define GCM_BATCH_BLOCKS 128
+
+static size_t gcm_job_blocks(const aes_gcm_job *job)
+{
+    return 1 + (job->length + 15) / 16; // E(K, J0) + ݵļ
+}
+
+static void gcm_batch_group(const aes_gcm_ctx *ctx, aes_gcm_job *jobs, size_t n, int encrypt)
+{
+    byte counters[GCM_BATCH_BLOCKS * 16], keystream[GCM_BATCH_BLOCKS * 16];
+    size_t pos = 0;
+
+    if (n == 0)
+        return;
+    for (size_t i = 0; i < n; i++) {
+        byte *J0 = counters + pos * 16;
+        size_t nblocks = gcm_job_blocks(&jobs[i]);
+        compute_J0(ctx, jobs[i].iv, jobs[i].iv_len, J0);
+        uint32_t c = load_be32(J0 + 12);
+        for (size_t b = 1; b < nblocks; b++) {
+            memcpy(J0 + b * 16, J0, 12);
+            store_be32(J0 + b * 16 + 12, c + (uint32_t)b); // inc_32
+        }
+        pos += nblocks;
     }
-    return (int)ct_len;  // ɹĳ
-}
\ No newline at end of file
+    aes_encrypt_blocks(&ctx->key, counters, keystream, pos);
+
+    pos = 0;
+    for (size_t i = 0; i < n; i++) {
+        aes_gcm_job *job = &jobs[i];
+        const byte *stream = keystream + (pos + 1) * 16;
+        byte S[16] = {0}, len_block[16], tag[16];
+
+        if (job->aad_len > 0)
+            ghash(ctx, job->aad, job->aad_len, S);
+        if (encrypt) {
+            xor_bytes(job->output, job->input, stream, job->length);
+            ghash(ctx, job->output, job->length, S);
+        } else {
+            ghash(ctx, job->input, job->length, S);
+        }
+        gcm_len_block(len_block, job->aad_len, job->length);
+        ghash(ctx, len_block, 16, S);
+        for (int k = 0; k < 16; k++)
+            tag[k] = keystream[pos * 16 + k] ^ S[k]; // E(K, J0) ^ S
+
+        if (encrypt) {
+            memcpy(job->tag, tag, 16);
+            job->result = 0;
+        } else if (ct_equal(job->tag, tag, GCM_TAG_SIZE)) {
+            xor_bytes(job->output, job->input, stream, job->length);
+            job->result = 0;
+        } else {
+            job->result = -1;
+        }
+        pos += gcm_job_blocks(job);
+    }
+    secure_zero(counters, sizeof(counters)); // Ϣ J0E(K, J0) ڱǩ
+    secure_zero(keystream, sizeof(keystream));
+}
+
+static size_t gcm_batch(const aes_gcm_ctx *ctx, aes_gcm_job *jobs, size_t n, int encrypt)
+{
+    size_t failures = 0;
+    size_t i = 0;
+    while (i < n) {
+        aes_gcm_job *job = &jobs[i];
+        if (gcm_job_blocks(job) > GCM_BATCH_BLOCKS || job->iv_len == 0) {
+            job->result = encrypt
+                ? aes_gcm_encrypt_ctx(ctx, job->iv, job->iv_len, job->input, job->length, job->aad, job->aad_len,
+                                      job->output, job->tag)
+                : aes_gcm_verify_decrypt_ctx(ctx, job->iv, job->iv_len, job->input, job->length, job->aad,
+                                             job->aad_len, job->output, job->tag);
+            i++;
+            continue;
+        }
+        size_t end = i, total = 0;
+        while (end < n && jobs[end].iv_len != 0 && total + gcm_job_blocks(&jobs[end]) <= GCM_BATCH_BLOCKS) {
+            total += gcm_job_blocks(&jobs[end]);
+            end++;
+        }
+        gcm_batch_group(ctx, jobs + i, end - i, encrypt);
+        i = end;
+    }
+    for (i = 0; i < n; i++)
+        failures += jobs[i].result < 0;
+    return failures;
+}
+
+size_t aes_gcm_encrypt_batch(const aes_gcm_ctx *ctx, aes_gcm_job *jobs, size_t n)
+{
+    return gcm_batch(ctx, jobs, n, 1);
+}
+
+size_t aes_gcm_decrypt_batch(const aes_gcm_ctx *ctx, aes_gcm_job *jobs, size_t n)
+{
+    return gcm_batch(ctx, jobs, n, 0);
+}
+
+int aes_gcm_decrypt(const byte *key, const byte *iv, size_t iv_len, const byte *ciphertext, size_t ct_len,
+                    const byte *aad, size_t aad_len, byte *plaintext, byte *tag)
+{
+    aes_gcm_ctx ctx;
+    if (aes_gcm_key_init(&ctx, key, 16) != 0) {
+        aes_gcm_key_clear(&ctx);
+        return -1;
+    }
+    int ret = aes_gcm_decrypt_ctx(&ctx, iv, iv_len, ciphertext, ct_len, aad, aad_len, plaintext, tag);
+    aes_gcm_key_clear(&ctx);
+    return ret;
+}
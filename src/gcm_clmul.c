@@ -0,0 +1,263 @@
+#include "gcm_internal.h"
+#include "aes_engine.h"
+#include "crypto/cpu.h"
+#include <string.h>
+
+// PCLMULQDQ 实现的 GHASH    参考 Intel "Carry-Less Multiplication Instruction and its Usage for Computing the GCM Mode"
+// 分组按字节逆序载入后，GCM 的反射比特序正好对应普通多项式乘积再整体左移一位；
+// 乘积在约简前是线性的，所以 8 个分组各乘 H^8..H^1 后先把 256 位结果异或在一起，只做一次约简
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <wmmintrin.h>
+#include <tmmintrin.h>
+
+#define CLMUL_TARGET __attribute__((target("pclmul,ssse3")))
+#define STITCH_TARGET __attribute__((target("aes,pclmul,ssse3")))
+
+static int clmul_available(void)
+{
+    return crypto_cpu_has(CPU_FEATURE_PCLMUL | CPU_FEATURE_SSSE3);
+}
+
+CLMUL_TARGET static inline __m128i bswap128(__m128i x)
+{
+    const __m128i mask = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    return _mm_shuffle_epi8(x, mask);
+}
+
+// Karatsuba：lo += a0·b0，hi += a1·b1，mid += (a0^a1)·(b0^b1)，三者都不约简
+CLMUL_TARGET static inline void clmul_acc(__m128i a, __m128i b, __m128i *lo, __m128i *mid, __m128i *hi)
+{
+    __m128i as = _mm_xor_si128(a, _mm_shuffle_epi32(a, 0x4e));
+    __m128i bs = _mm_xor_si128(b, _mm_shuffle_epi32(b, 0x4e));
+    *lo = _mm_xor_si128(*lo, _mm_clmulepi64_si128(a, b, 0x00));
+    *hi = _mm_xor_si128(*hi, _mm_clmulepi64_si128(a, b, 0x11));
+    *mid = _mm_xor_si128(*mid, _mm_clmulepi64_si128(as, bs, 0x00));
+}
+
+// 合并 256 位乘积 <hi:lo>，左移一位回到 GCM 比特序，再按 x^128 + x^7 + x^2 + x + 1 约简
+CLMUL_TARGET static inline __m128i clmul_reduce(__m128i lo, __m128i mid, __m128i hi)
+{
+    mid = _mm_xor_si128(mid, _mm_xor_si128(lo, hi));
+    lo = _mm_xor_si128(lo, _mm_slli_si128(mid, 8));
+    hi = _mm_xor_si128(hi, _mm_srli_si128(mid, 8));
+
+    __m128i t1 = _mm_srli_epi32(lo, 31);
+    __m128i t2 = _mm_srli_epi32(hi, 31);
+    lo = _mm_slli_epi32(lo, 1);
+    hi = _mm_slli_epi32(hi, 1);
+    __m128i t3 = _mm_srli_si128(t1, 12);
+    t2 = _mm_slli_si128(t2, 4);
+    t1 = _mm_slli_si128(t1, 4);
+    lo = _mm_or_si128(lo, t1);
+    hi = _mm_or_si128(hi, t2);
+    hi = _mm_or_si128(hi, t3);
+
+    t1 = _mm_slli_epi32(lo, 31);
+    t2 = _mm_slli_epi32(lo, 30);
+    t3 = _mm_slli_epi32(lo, 25);
+    t1 = _mm_xor_si128(t1, _mm_xor_si128(t2, t3));
+    t2 = _mm_srli_si128(t1, 4);
+    t1 = _mm_slli_si128(t1, 12);
+    lo = _mm_xor_si128(lo, t1);
+
+    t3 = _mm_srli_epi32(lo, 1);
+    t1 = _mm_srli_epi32(lo, 2);
+    t3 = _mm_xor_si128(t3, t1);
+    t1 = _mm_srli_epi32(lo, 7);
+    t3 = _mm_xor_si128(t3, t1);
+    t3 = _mm_xor_si128(t3, t2);
+    lo = _mm_xor_si128(lo, t3);
+    return _mm_xor_si128(hi, lo);
+}
+
+CLMUL_TARGET static inline __m128i clmul_mul(__m128i a, __m128i b)
+{
+    __m128i lo = _mm_setzero_si128(), mid = _mm_setzero_si128(), hi = _mm_setzero_si128();
+    clmul_acc(a, b, &lo, &mid, &hi);
+    return clmul_reduce(lo, mid, hi);
+}
+
+// Hpow[i] = H^(i+1)，以字节逆序存放，可直接载入使用
+CLMUL_TARGET static void clmul_init(aes_gcm_ctx *ctx)
+{
+    __m128i h = bswap128(_mm_loadu_si128((const __m128i *)ctx->H));
+    __m128i p = h;
+    _mm_storeu_si128((__m128i *)ctx->Hpow[0], h);
+    for (int i = 1; i < GCM_AGG_BLOCKS; i++) {
+        p = clmul_mul(p, h);
+        _mm_storeu_si128((__m128i *)ctx->Hpow[i], p);
+    }
+}
+
+// GHASH 与 POLYVAL 共用同一个循环：POLYVAL（RFC 8452 附录 A）的分组就是 GHASH 分组的字节逆序，
+// 而这里本来就要把分组逆序后再乘，所以 reflect 为 0 时省掉逆序，直接得到 POLYVAL（H 表中存的是 mulX_GHASH(ByteReverse(H))）
+#define CLMUL_INLINE static inline __attribute__((always_inline)) CLMUL_TARGET
+
+CLMUL_INLINE __m128i clmul_load(const byte *p, const int reflect)
+{
+    __m128i x = _mm_loadu_si128((const __m128i *)p);
+    return reflect ? bswap128(x) : x;
+}
+
+CLMUL_INLINE void clmul_hash(const aes_gcm_ctx *ctx, byte Y[16], const byte *X, size_t len, const int reflect)
+{
+    __m128i y = clmul_load(Y, reflect);
+    __m128i h1 = _mm_loadu_si128((const __m128i *)ctx->Hpow[0]);
+
+    // Y' = (Y ^ X0)·H^8 ^ X1·H^7 ^ ... ^ X7·H，每 8 个分组约简一次
+    while (len >= GCM_AGG_BLOCKS * 16) {
+        __m128i lo = _mm_setzero_si128(), mid = _mm_setzero_si128(), hi = _mm_setzero_si128();
+        __m128i x = _mm_xor_si128(y, clmul_load(X, reflect));
+        clmul_acc(x, _mm_loadu_si128((const __m128i *)ctx->Hpow[GCM_AGG_BLOCKS - 1]), &lo, &mid, &hi);
+#pragma GCC unroll 8
+        for (int b = 1; b < GCM_AGG_BLOCKS; b++) {
+            x = clmul_load(X + 16 * b, reflect);
+            clmul_acc(x, _mm_loadu_si128((const __m128i *)ctx->Hpow[GCM_AGG_BLOCKS - 1 - b]), &lo, &mid, &hi);
+        }
+        y = clmul_reduce(lo, mid, hi);
+        X += GCM_AGG_BLOCKS * 16;
+        len -= GCM_AGG_BLOCKS * 16;
+    }
+    while (len >= 16) {
+        y = clmul_mul(_mm_xor_si128(y, clmul_load(X, reflect)), h1);
+        X += 16;
+        len -= 16;
+    }
+    if (len > 0) {
+        byte last[16] = {0};
+        memcpy(last, X, len);
+        y = clmul_mul(_mm_xor_si128(y, clmul_load(last, reflect)), h1);
+    }
+    if (reflect)
+        y = bswap128(y);
+    _mm_storeu_si128((__m128i *)Y, y);
+}
+
+CLMUL_TARGET static void clmul_ghash(const aes_gcm_ctx *ctx, byte Y[16], const byte *X, size_t len)
+{
+    clmul_hash(ctx, Y, X, len, 1);
+}
+
+CLMUL_TARGET static void clmul_polyval(const aes_gcm_ctx *ctx, byte Y[16], const byte *X, size_t len)
+{
+    clmul_hash(ctx, Y, X, len, 0);
+}
+
+// 缝合核：每批 8 个计数器块做 AES，在各轮 AESENC 之间插入 8 个密文分组的 CLMUL，
+// 两种指令走不同的执行单元，互相填补流水线空隙；数据只读写一遍
+// 解密时这批要吸收的就是本批输入；加密时本批密文要等 AES 做完才有，所以吸收的是上一批的输出
+// 以下函数体的 nr、encrypt 在每个实例中是常量，always_inline 加 unroll 使轮序列完全展开、分支消失
+#define STITCH_INLINE static inline __attribute__((always_inline)) STITCH_TARGET
+
+STITCH_INLINE __m128i stitch_batch(const aes_gcm_ctx *ctx, __m128i c, const byte *in, byte *out, const byte *h,
+                                   __m128i *y, const int hash, const int nr)
+{
+    const __m128i *rk = (const __m128i *)ctx->key.roundKeys;
+    const __m128i one = _mm_set_epi32(0, 0, 0, 1);
+    __m128i m[GCM_AGG_BLOCKS];
+    __m128i lo = _mm_setzero_si128(), mid = _mm_setzero_si128(), hi = _mm_setzero_si128();
+    __m128i k = _mm_loadu_si128(rk);
+
+    // c 为字节逆序的计数器块，最低 32 位即大端的 inc_32 计数器
+    for (int b = 0; b < GCM_AGG_BLOCKS; b++) {
+        c = _mm_add_epi32(c, one);
+        m[b] = _mm_xor_si128(bswap128(c), k);
+    }
+#pragma GCC unroll 16
+    for (int i = 1; i < nr; i++) {
+        k = _mm_loadu_si128(rk + i);
+#pragma GCC unroll 8
+        for (int b = 0; b < GCM_AGG_BLOCKS; b++) m[b] = _mm_aesenc_si128(m[b], k);
+        if (hash && i <= GCM_AGG_BLOCKS) {
+            __m128i x = bswap128(_mm_loadu_si128((const __m128i *)(h + 16 * (i - 1))));
+            if (i == 1) x = _mm_xor_si128(x, *y);
+            clmul_acc(x, _mm_loadu_si128((const __m128i *)ctx->Hpow[GCM_AGG_BLOCKS - i]), &lo, &mid, &hi);
+        }
+    }
+    if (hash) *y = clmul_reduce(lo, mid, hi);
+    k = _mm_loadu_si128(rk + nr);
+    for (int b = 0; b < GCM_AGG_BLOCKS; b++) {
+        __m128i ks = _mm_aesenclast_si128(m[b], k);
+        _mm_storeu_si128((__m128i *)out + b, _mm_xor_si128(ks, _mm_loadu_si128((const __m128i *)in + b)));
+    }
+    return c;
+}
+
+STITCH_INLINE size_t stitch_body(const aes_gcm_ctx *ctx, byte ctr[16], const byte *in, byte *out, size_t len,
+                                 byte Y[16], const int encrypt, const int nr)
+{
+    const size_t batch = GCM_AGG_BLOCKS * 16;
+    __m128i c = bswap128(_mm_loadu_si128((const __m128i *)ctr));
+    __m128i y = bswap128(_mm_loadu_si128((const __m128i *)Y));
+    size_t done = 0;
+
+    if (encrypt) {
+        c = stitch_batch(ctx, c, in, out, NULL, &y, 0, nr);
+        for (done = batch; len - done >= batch; done += batch) {
+            c = stitch_batch(ctx, c, in + done, out + done, out + done - batch, &y, 1, nr);
+        }
+        // 最后一批密文单独吸收
+        __m128i lo = _mm_setzero_si128(), mid = _mm_setzero_si128(), hi = _mm_setzero_si128();
+        const byte *h = out + done - batch;
+        for (int b = 0; b < GCM_AGG_BLOCKS; b++) {
+            __m128i x = bswap128(_mm_loadu_si128((const __m128i *)(h + 16 * b)));
+            if (b == 0) x = _mm_xor_si128(x, y);
+            clmul_acc(x, _mm_loadu_si128((const __m128i *)ctx->Hpow[GCM_AGG_BLOCKS - 1 - b]), &lo, &mid, &hi);
+        }
+        y = clmul_reduce(lo, mid, hi);
+    } else {
+        for (; len - done >= batch; done += batch) {
+            c = stitch_batch(ctx, c, in + done, out + done, in + done, &y, 1, nr);
+        }
+    }
+    _mm_storeu_si128((__m128i *)ctr, bswap128(c));
+    _mm_storeu_si128((__m128i *)Y, bswap128(y));
+    return done;
+}
+
+#define STITCH_VARIANTS(nr)                                                                               \
+    STITCH_TARGET static void stitch_encrypt_##nr(const aes_gcm_ctx *ctx, byte ctr[16], const byte *in,   \
+                                                  byte *out, size_t len, byte Y[16], size_t *done)        \
+    {                                                                                                     \
+        *done = stitch_body(ctx, ctr, in, out, len, Y, 1, nr);                                            \
+    }                                                                                                     \
+    STITCH_TARGET static void stitch_decrypt_##nr(const aes_gcm_ctx *ctx, byte ctr[16], const byte *in,   \
+                                                  byte *out, size_t len, byte Y[16], size_t *done)        \
+    {                                                                                                     \
+        *done = stitch_body(ctx, ctr, in, out, len, Y, 0, nr);                                            \
+    }
+
+STITCH_VARIANTS(10)
+STITCH_VARIANTS(12)
+STITCH_VARIANTS(14)
+
+// 调用者保证 len 至少一批
+static size_t clmul_crypt_aesni(const aes_gcm_ctx *ctx, byte ctr[16], const byte *in, byte *out, size_t len,
+                                byte Y[16], int encrypt)
+{
+    size_t done = 0;
+    if (encrypt) {
+        AES_ROUNDS_DISPATCH(ctx->key.rounds, stitch_encrypt, ctx, ctr, in, out, len, Y, &done);
+    } else {
+        AES_ROUNDS_DISPATCH(ctx->key.rounds, stitch_decrypt, ctx, ctr, in, out, len, Y, &done);
+    }
+    return done;
+}
+
+const struct gcm_ghash_impl gcm_ghash_clmul = {
+    "clmul", clmul_available, clmul_init, clmul_ghash, clmul_polyval, clmul_crypt_aesni,
+};
+
+#else
+
+static int clmul_available(void)
+{
+    return 0;
+}
+
+const struct gcm_ghash_impl gcm_ghash_clmul = {
+    "clmul", clmul_available, NULL, NULL, NULL, NULL,
+};
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef GCM_INTERNAL_H
+#define GCM_INTERNAL_H
+
+#include "crypto/gcm.h"
+
+// GHASH 实现接口：aes_gcm_key_init 按 CPU 选择一个，之后同一上下文的所有消息都用它
+struct gcm_ghash_impl {
+    const char *name;
+    int (*available)(void);   // 当前CPU是否支持，NULL表示总是可用
+    void (*init)(aes_gcm_ctx *ctx); // 由 ctx->H 预计算乘法表或 H 的幂
+    // Y = (Y ^ X_1)·H ... 依次吸收 X 的每个分组，最后不足一块的部分补零
+    void (*ghash)(const aes_gcm_ctx *ctx, byte Y[16], const byte *X, size_t len);
+    // POLYVAL（RFC 8452）：Y 与 X 均按 POLYVAL 的字节序，ctx->H 中为 mulX_GHASH(ByteReverse(H))；
+    // 可为NULL，此时由调用者把每个分组字节逆序后交给 ghash
+    void (*polyval)(const aes_gcm_ctx *ctx, byte Y[16], const byte *X, size_t len);
+    // 与 AES-NI 引擎缝合的 CTR + GHASH 核（只在上下文使用 aesni 引擎时调用），可为NULL：
+    // 处理 len 中整批的分组，计数器块 ctr（每个分组使用前先 inc_32）与 GHASH 状态 Y 返回时更新，
+    // 加密时对输出、解密时对输入做 GHASH；返回处理的字节数，剩余部分由调用者完成
+    size_t (*crypt_aesni)(const aes_gcm_ctx *ctx, byte ctr[16], const byte *in, byte *out, size_t len, byte Y[16],
+                          int encrypt);
+};
+
+extern const struct gcm_ghash_impl gcm_ghash_table; // Shoup 查表（gcm.c）
+extern const struct gcm_ghash_impl gcm_ghash_clmul; // PCLMULQDQ（gcm_clmul.c）
+
+// 按名字取当前 CPU 可用的实现，NULL 表示按优先级自动选择；不存在或不可用返回 NULL
+const struct gcm_ghash_impl *gcm_ghash_select(const char *name);
+
+#endif // GCM_INTERNAL_H
@@ -0,0 +1,219 @@
+#include "gcm_internal.h"
+#include "crypto/gcm_siv.h"
+#include <string.h>
+
+// AES-GCM-SIV    参考 RFC 8452
+// 每条消息先由主密钥与 nonce 派生认证密钥和加密密钥（4.），标签 = E(K_enc, POLYVAL(A || P || len) ⊕ nonce，最高位清零)，
+// 再以标签（最高位置一）为初始计数器做 CTR。标签依赖整条明文，所以 nonce 重复只暴露两条消息是否相同
+//
+// POLYVAL 不另写乘法：RFC 8452 附录 A 给出
+//   POLYVAL(H, X_1, ..., X_n) = ByteReverse(GHASH(mulX_GHASH(ByteReverse(H)), ByteReverse(X_1), ..., ByteReverse(X_n)))
+// 于是把 H' = mulX_GHASH(ByteReverse(H)) 放进一个临时的 aes_gcm_ctx，按上下文所选实现（查表或 CLMUL）初始化，
+// 与 GCM 共用同一个乘法核（CLMUL 实现里两者只差分组载入时是否逆序，查表实现则逐块逆序后调用 GHASH）
+
+#define SIV_BATCH 8          // CTR 每次交给 AES 引擎的分组数，与 GCM 的 GCTR_BATCH 相同
+#define POLYVAL_CHUNK 32     // 每次逆序后送入 GHASH 的分组数
+
+static uint32_t load_le32(const byte *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void store_le32(byte *p, uint32_t v)
+{
+    p[0] = (byte)v;
+    p[1] = (byte)(v >> 8);
+    p[2] = (byte)(v >> 16);
+    p[3] = (byte)(v >> 24);
+}
+
+static void store_le64(byte *p, uint64_t v)
+{
+    for (int i = 0; i < 8; i++)
+        p[i] = (byte)(v >> (8 * i));
+}
+
+static void byte_reverse(byte out[16], const byte in[16])
+{
+    for (int i = 0; i < 16; i++)
+        out[i] = in[15 - i];
+}
+
+// GHASH 比特序下乘以 x：整体右移一位，移出的位按 x^128 + x^7 + x^2 + x + 1 约简回最高字节
+static void mulx_ghash(byte V[16])
+{
+    byte carry = V[15] & 1;
+    for (int i = 15; i > 0; i--)
+        V[i] = (byte)((V[i] >> 1) | (V[i - 1] << 7));
+    V[0] >>= 1;
+    if (carry)
+        V[0] ^= 0xe1;
+}
+
+// S 为 POLYVAL 状态。GHASH 实现有原生 POLYVAL 入口（CLMUL）时直接调用；否则（查表）状态与每个分组都字节逆序后
+// 交给 ghash，最后不满一块的部分先补零再逆序（补零在原分组的末尾）
+static void polyval(const aes_gcm_ctx *h, byte S[16], const byte *X, size_t len)
+{
+    byte buf[POLYVAL_CHUNK * 16], Y[16];
+    if (h->ghash->polyval != NULL) {
+        h->ghash->polyval(h, S, X, len);
+        return;
+    }
+    byte_reverse(Y, S);
+    while (len > 0) {
+        size_t n = len < sizeof(buf) ? len : sizeof(buf);
+        size_t full = n / 16;
+        for (size_t b = 0; b < full; b++)
+            byte_reverse(buf + 16 * b, X + 16 * b);
+        if (n % 16) {
+            byte last[16] = {0};
+            memcpy(last, X + 16 * full, n % 16);
+            byte_reverse(buf + 16 * full, last);
+            full++;
+        }
+        h->ghash->ghash(h, Y, buf, 16 * full);
+        X += n;
+        len -= n;
+    }
+    byte_reverse(S, Y);
+}
+
+// 派生本条消息的密钥（4.）：第 i 块输入为 LE32(i) || nonce，每块输出只取前 8 字节；
+// 前两块组成 POLYVAL 密钥，之后两块（AES-128）或四块（AES-256）组成加密密钥。加密密钥用与主密钥相同的引擎展开，
+// GCM-SIV 只用 AES 加密方向，不生成解密轮密钥
+static int siv_derive_keys(const aes_gcm_siv_ctx *ctx, const byte nonce[GCM_SIV_NONCE_SIZE], aes_gcm_ctx *msg)
+{
+    byte in[6][16], out[6][16], auth[16], enc[32];
+    size_t enc_len = (ctx->key.rounds == 14) ? 32 : 16;
+    size_t nblocks = 2 + enc_len / 8;
+    int ret;
+
+    for (size_t i = 0; i < nblocks; i++) {
+        store_le32(in[i], (uint32_t)i);
+        memcpy(in[i] + 4, nonce, GCM_SIV_NONCE_SIZE);
+    }
+    aes_encrypt_blocks(&ctx->key, in[0], out[0], nblocks);
+    memcpy(auth, out[0], 8);
+    memcpy(auth + 8, out[1], 8);
+    for (size_t i = 2; i < nblocks; i++)
+        memcpy(enc + 8 * (i - 2), out[i], 8);
+
+    ret = aes_key_setup_encrypt_engine(&msg->key, enc, enc_len, aes_engine_name(&ctx->key));
+    byte_reverse(msg->H, auth);
+    mulx_ghash(msg->H);
+    msg->ghash = ctx->ghash;
+    msg->ghash->init(msg);
+
+    secure_zero(out, sizeof(out));
+    secure_zero(auth, sizeof(auth));
+    secure_zero(enc, sizeof(enc));
+    return ret;
+}
+
+// 标签（4.）：S = POLYVAL(H, A || P || LE64(len(A)) || LE64(len(P)))，前 12 字节异或 nonce，最高位清零后加密
+static void siv_tag(const aes_gcm_ctx *msg, const byte nonce[GCM_SIV_NONCE_SIZE], const byte *aad, size_t aad_len,
+                    const byte *plaintext, size_t pt_len, byte tag[16])
+{
+    byte S[16] = {0}, len_block[16];
+    if (aad_len > 0)
+        polyval(msg, S, aad, aad_len);
+    if (pt_len > 0)
+        polyval(msg, S, plaintext, pt_len);
+    store_le64(len_block, (uint64_t)aad_len * 8);
+    store_le64(len_block + 8, (uint64_t)pt_len * 8);
+    polyval(msg, S, len_block, 16);
+
+    memcpy(tag, S, 16);
+    for (int i = 0; i < GCM_SIV_NONCE_SIZE; i++)
+        tag[i] ^= nonce[i];
+    tag[15] &= 0x7f;
+    aes_encrypt_block(&msg->key, tag, tag);
+}
+
+// CTR（4.）：初始计数器为标签且最高位置一，之后只对前 4 字节按小端 32 位递增（模 2^32）
+static void siv_ctr(const aes_gcm_ctx *msg, const byte tag[16], const byte *in, byte *out, size_t len)
+{
+    byte ctr[SIV_BATCH * 16], ks[SIV_BATCH * 16];
+    uint32_t c = load_le32(tag);
+
+    for (int b = 0; b < SIV_BATCH; b++) {
+        memcpy(ctr + 16 * b, tag, 16);
+        ctr[16 * b + 15] |= 0x80;
+    }
+    while (len > 0) {
+        size_t n = len < sizeof(ks) ? len : sizeof(ks);
+        size_t blocks = (n + 15) / 16;
+        for (size_t b = 0; b < blocks; b++)
+            store_le32(ctr + 16 * b, c++);
+        aes_encrypt_blocks(&msg->key, ctr, ks, blocks);
+        xor_bytes(out, in, ks, n);
+        in += n;
+        out += n;
+        len -= n;
+    }
+    secure_zero(ks, sizeof(ks));
+}
+
+int aes_gcm_siv_key_init_ghash(aes_gcm_siv_ctx *ctx, const byte *key, size_t key_len, const char *ghash_name)
+{
+    const struct gcm_ghash_impl *impl = gcm_ghash_select(ghash_name);
+    if (impl == NULL || (key_len != 16 && key_len != 32))
+        return -1;
+    if (aes_key_setup(&ctx->key, key, key_len) != 0)
+        return -1;
+    ctx->ghash = impl;
+    return 0;
+}
+
+int aes_gcm_siv_key_init(aes_gcm_siv_ctx *ctx, const byte *key, size_t key_len)
+{
+    return aes_gcm_siv_key_init_ghash(ctx, key, key_len, NULL);
+}
+
+void aes_gcm_siv_key_clear(aes_gcm_siv_ctx *ctx)
+{
+    secure_zero(ctx, sizeof(*ctx));
+}
+
+// 加密（4.）：先对明文算标签再做 CTR，因此支持原地加密；数据要读两遍，这是 SIV 结构本身决定的
+int aes_gcm_siv_encrypt_ctx(const aes_gcm_siv_ctx *ctx, const byte nonce[GCM_SIV_NONCE_SIZE], const byte *plaintext,
+                            size_t pt_len, const byte *aad, size_t aad_len, byte *ciphertext,
+                            byte tag[GCM_SIV_TAG_SIZE])
+{
+    aes_gcm_ctx msg;
+    if ((uint64_t)pt_len > GCM_SIV_MAX_LEN || (uint64_t)aad_len > GCM_SIV_MAX_LEN)
+        return -1;
+    if (siv_derive_keys(ctx, nonce, &msg) != 0) {
+        secure_zero(&msg, sizeof(msg));  // 派生失败时 msg 里可能已有部分密钥材料
+        return -1;
+    }
+    siv_tag(&msg, nonce, aad, aad_len, plaintext, pt_len, tag);
+    siv_ctr(&msg, tag, plaintext, ciphertext, pt_len);
+    secure_zero(&msg, sizeof(msg));
+    return 0;
+}
+
+// 解密（5.）：先用收到的标签做 CTR 得到明文，再对明文重算标签并常量时间比较，不一致时清零输出
+int aes_gcm_siv_decrypt_ctx(const aes_gcm_siv_ctx *ctx, const byte nonce[GCM_SIV_NONCE_SIZE], const byte *ciphertext,
+                            size_t ct_len, const byte *aad, size_t aad_len, byte *plaintext,
+                            const byte tag[GCM_SIV_TAG_SIZE])
+{
+    aes_gcm_ctx msg;
+    byte expected_tag[16];
+    int ok;
+    if ((uint64_t)ct_len > GCM_SIV_MAX_LEN || (uint64_t)aad_len > GCM_SIV_MAX_LEN)
+        return -1;
+    if (siv_derive_keys(ctx, nonce, &msg) != 0) {
+        secure_zero(&msg, sizeof(msg));  // 派生失败时 msg 里可能已有部分密钥材料
+        return -1;
+    }
+    siv_ctr(&msg, tag, ciphertext, plaintext, ct_len);
+    siv_tag(&msg, nonce, aad, aad_len, plaintext, ct_len, expected_tag);
+    secure_zero(&msg, sizeof(msg));
+    ok = ct_equal(tag, expected_tag, GCM_SIV_TAG_SIZE);
+    if (!ok) {
+        secure_zero(plaintext, ct_len);
+        return -1;  // CRYPTO_ERR_MAC
+    }
+    return 0;
+}
@@ -26,15 +26,16 @@ void hmac_sha256(const byte *key, size_t key_len,
         i_key_pad[i] = key_block[i] ^ 0x36; //ipad = 0x36重复填充64字节
     }
 
-    // Step 3: 进行内层哈希
-    byte inner_data[HMAC_BLOCK_SIZE + message_len];
-    memcpy(inner_data, i_key_pad, HMAC_BLOCK_SIZE);
-    memcpy(inner_data + HMAC_BLOCK_SIZE, message, message_len);
-    sha256(inner_data, HMAC_BLOCK_SIZE + message_len, inner_hash);
+    // Step 3: 进行内层哈希，消息直接分段输入，不再拼接到栈上的临时缓冲
+    sha256_ctx sha;
+    sha256_init(&sha);
+    sha256_update(&sha, i_key_pad, HMAC_BLOCK_SIZE);
+    sha256_update(&sha, message, message_len);
+    sha256_final(&sha, inner_hash);
 
     // Step 4: 进行外层哈希
-    byte outer_data[HMAC_BLOCK_SIZE + HMAC_HASH_SIZE];
-    memcpy(outer_data, o_key_pad, HMAC_BLOCK_SIZE);
-    memcpy(outer_data + HMAC_BLOCK_SIZE, inner_hash, HMAC_HASH_SIZE);
-    sha256(outer_data, HMAC_BLOCK_SIZE + HMAC_HASH_SIZE, out_digest);
+    sha256_init(&sha);
+    sha256_update(&sha, o_key_pad, HMAC_BLOCK_SIZE);
+    sha256_update(&sha, inner_hash, HMAC_HASH_SIZE);
+    sha256_final(&sha, out_digest);
 }
\ No newline at end of file
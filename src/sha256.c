@@ -1,20 +1,6 @@
-#include "crypto/sha256.h"
-
-// 循环右移n位  对应FIPS180-4的3.2.4
-#define ROTRIGHT(word, bits) (((word) >> (bits)) | ((word) << (32 - (bits))))
-
-// 选择函数 对应FIPS180-4的4.1.2
-#define CH(x, y, z) (((x) & (y)) ^ (~(x) & (z)))
-
-// 多路选择函数 对应FIPS180-4的4.1.2
-#define MAJ(x, y, z) (((x) & (y)) ^ ((x) & (z)) ^ ((y) & (z)))
-
-// 大写希格玛函数 对应FIPS180-4的4.1.2 用于工作变量
-#define EP0(x) (ROTRIGHT(x, 2) ^ ROTRIGHT(x, 13) ^ ROTRIGHT(x, 22))
-#define EP1(x) (ROTRIGHT(x, 6) ^ ROTRIGHT(x, 11) ^ ROTRIGHT(x, 25))
-// 小写希格玛函数 对应FIPS180-4的4.1.2 用于消息调度
-#define SIG0(x) (ROTRIGHT(x, 7) ^ ROTRIGHT(x, 18) ^ ((x) >> 3))
-#define SIG1(x) (ROTRIGHT(x, 17) ^ ROTRIGHT(x, 19) ^ ((x) >> 10))
+#include "sha256_internal.h"
+#include "common.h"
+#include <stdatomic.h>
 
 const uint32_t sha256_initial_hash[8] = { // 每个值取自前八个素数的平方根小数部分的前32位
     0x6a09e667,
@@ -36,30 +22,6 @@ const uint32_t sha256_round_constants[64] = {
     0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
     0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
 
-static void sha256_pad(const byte *input, size_t input_len, byte **padded_msg, size_t *padded_len)
-{
-
-    size_t remainder = input_len % SHA256_BLOCK_SIZE;                             // 最后一个块中的字节数
-    size_t padding_len = (remainder < 56) ? (56 - remainder) : (120 - remainder); // 需要预留8字节存放原始消息的长度
-    *padded_len = input_len + padding_len + 8;                                    // 总长度=原始长度+填充长度+8字节长度信息
-    *padded_msg = (byte *)malloc(*padded_len);
-    if (*padded_msg == NULL)
-    {
-        printf("Memory allocation failed\n");
-        exit(1);
-    }
-    memcpy(*padded_msg, input, input_len);                   // 复制原始消息
-    (*padded_msg)[input_len] = 0x80;                         // 将0x80添加到填充开始处
-    memset(*padded_msg + input_len + 1, 0, padding_len - 1); // 填充0x00
-
-    uint64_t bit_len = input_len * 8;
-    // 将最后8字节的长度信息存储为大端格式
-    for (int i = 0; i < 8; i++)
-    {
-        (*padded_msg)[*padded_len - 1 - i] = (byte)((bit_len >> (i * 8)) & 0xFF);
-    }
-}
-
 static void sha256_compress(const byte *block, uint32_t hash[8])
 {
     uint32_t w[64];
@@ -110,34 +72,406 @@ static void sha256_compress(const byte *block, uint32_t hash[8])
     hash[7] += h;
 }
 
-void sha256(const byte *input, size_t input_len, byte *digest)
+static void scalar_compress(uint32_t state[8], const byte *data, size_t nblocks)
+{
+    for (; nblocks > 0; nblocks--, data += SHA256_BLOCK_SIZE)
+    {
+        sha256_compress(data, state);
+    }
+}
+
+const struct sha256_impl sha256_impl_scalar = {
+    "scalar", NULL, scalar_compress,
+};
+
+// 按优先级排列，首次哈希时选第一个可用的
+static const struct sha256_impl *const sha256_impls[] = {
+    &sha256_impl_shani,
+    &sha256_impl_avx2,
+    &sha256_impl_ssse3,
+    &sha256_impl_scalar,
+};
+
+// 当前使用的实现。sha256_tree_update 的工作线程会同时首次调用，用原子读写；
+// 并发的首次选择用 CAS 发布，只有一个结果生效，其余线程采用已发布的实现
+static _Atomic(const struct sha256_impl *) sha256_active = NULL;
+
+static int sha256_impl_usable(const struct sha256_impl *impl)
+{
+    return impl->available == NULL || impl->available();
+}
+
+static const struct sha256_impl *sha256_impl_get(void)
+{
+    const struct sha256_impl *impl = atomic_load_explicit(&sha256_active, memory_order_acquire);
+    if (impl == NULL)
+    {
+        const struct sha256_impl *expected = NULL;
+        for (size_t i = 0; impl == NULL; i++)
+        {
+            if (sha256_impl_usable(sha256_impls[i]))
+            {
+                impl = sha256_impls[i];
+            }
+        }
+        if (!atomic_compare_exchange_strong_explicit(&sha256_active, &expected, impl, memory_order_acq_rel,
+                                                     memory_order_acquire))
+        {
+            impl = expected;
+        }
+    }
+    return impl;
+}
+
+int sha256_select_impl(const char *name)
+{
+    for (size_t i = 0; i < sizeof(sha256_impls) / sizeof(sha256_impls[0]); i++)
+    {
+        const struct sha256_impl *impl = sha256_impls[i];
+        if (name == NULL ? sha256_impl_usable(impl) : strcmp(impl->name, name) == 0)
+        {
+            if (!sha256_impl_usable(impl))
+            {
+                return -1;
+            }
+            atomic_store_explicit(&sha256_active, impl, memory_order_release);
+            return 0;
+        }
+    }
+    return -1;
+}
+
+const char *sha256_impl_name(void)
+{
+    return sha256_impl_get()->name;
+}
+
+void sha256_init(sha256_ctx *ctx)
 {
-    uint32_t hash[8];
-    // 初始化哈希值
     for (int i = 0; i < 8; i++)
     {
-        hash[i] = sha256_initial_hash[i];
+        ctx->state[i] = sha256_initial_hash[i];
+    }
+    ctx->total_len = 0;
+    ctx->buffer_len = 0;
+}
+
+// 先补满缓冲中的残块，之后的完整分组直接从输入压缩，只有最后不足 64 字节的部分进入缓冲
+void sha256_update(sha256_ctx *ctx, const byte *data, size_t len)
+{
+    ctx->total_len += len;
+    if (ctx->buffer_len > 0)
+    {
+        size_t take = SHA256_BLOCK_SIZE - ctx->buffer_len;
+        if (take > len)
+        {
+            take = len;
+        }
+        memcpy(ctx->buffer + ctx->buffer_len, data, take);
+        ctx->buffer_len += take;
+        data += take;
+        len -= take;
+        if (ctx->buffer_len < SHA256_BLOCK_SIZE)
+        {
+            return;
+        }
+        sha256_impl_get()->compress(ctx->state, ctx->buffer, 1);
+        ctx->buffer_len = 0;
     }
+    if (len >= SHA256_BLOCK_SIZE) // 所有完整分组一次交给压缩函数
+    {
+        size_t nblocks = len / SHA256_BLOCK_SIZE;
+        sha256_impl_get()->compress(ctx->state, data, nblocks);
+        data += nblocks * SHA256_BLOCK_SIZE;
+        len -= nblocks * SHA256_BLOCK_SIZE;
+    }
+    memcpy(ctx->buffer, data, len);
+    ctx->buffer_len = len;
+}
 
-    // 消息填充
-    byte *padded_msg = NULL;
-    size_t padded_len = 0;
-    sha256_pad(input, input_len, &padded_msg, &padded_len);
+// 填充  对应FIPS180-4的5.1.1：消息最后不足一块的 tail_len 字节补 0x80 与若干 0x00，使长度模 64 余 56，
+// 再附 64 位大端的消息比特数；残块超过 55 字节时放不下长度字段，结果为两个分组。返回分组数
+static size_t sha256_pad(byte out[2 * SHA256_BLOCK_SIZE], const byte *tail, size_t tail_len, uint64_t total_len)
+{
+    size_t padded_len = (tail_len < SHA256_BLOCK_SIZE - 8) ? SHA256_BLOCK_SIZE : 2 * SHA256_BLOCK_SIZE;
+    uint64_t bit_len = total_len * 8;
 
-    for(size_t offset = 0; offset < padded_len; offset += SHA256_BLOCK_SIZE)
+    memcpy(out, tail, tail_len);
+    out[tail_len] = 0x80;
+    memset(out + tail_len + 1, 0, padded_len - 8 - tail_len - 1);
+    for (int i = 0; i < 8; i++)
     {
-        sha256_compress(padded_msg + offset, hash);
+        out[padded_len - 1 - i] = (byte)(bit_len >> (i * 8));
     }
+    return padded_len / SHA256_BLOCK_SIZE;
+}
 
-    free(padded_msg);
-    // 将最终哈希值转换为字节流（大端格式）
+// 将最终哈希值转换为字节流（大端格式）
+static void sha256_store_digest(const uint32_t state[8], byte digest[SHA256_HASH_SIZE])
+{
     for (int i = 0; i < 8; i++)
     {
-        digest[i * 4]     = (byte)((hash[i] >> 24) & 0xFF);
-        digest[i * 4 + 1] = (byte)((hash[i] >> 16) & 0xFF);
-        digest[i * 4 + 2] = (byte)((hash[i] >> 8) & 0xFF);
-        digest[i * 4 + 3] = (byte)(hash[i] & 0xFF);
+        digest[i * 4]     = (byte)((state[i] >> 24) & 0xFF);
+        digest[i * 4 + 1] = (byte)((state[i] >> 16) & 0xFF);
+        digest[i * 4 + 2] = (byte)((state[i] >> 8) & 0xFF);
+        digest[i * 4 + 3] = (byte)(state[i] & 0xFF);
+    }
+}
+
+void sha256_final(sha256_ctx *ctx, byte digest[SHA256_HASH_SIZE])
+{
+    byte last[2 * SHA256_BLOCK_SIZE];
+    size_t nblocks = sha256_pad(last, ctx->buffer, ctx->buffer_len, ctx->total_len);
+    sha256_impl_get()->compress(ctx->state, last, nblocks);
+    sha256_store_digest(ctx->state, digest);
+
+    // 缓冲区里可能是 HMAC 的密钥块或消息尾部
+    secure_zero(last, sizeof(last));
+    secure_zero(ctx, sizeof(*ctx));
+}
+
+void sha256(const byte *input, size_t input_len, byte *digest)
+{
+    sha256_ctx ctx;
+    sha256_init(&ctx);
+    sha256_update(&ctx, input, input_len);
+    sha256_final(&ctx, digest);
+}
+
+// 多通道调度    每条通道上一条消息依次经过两段连续分组：消息本身的完整分组，以及填充后的尾部（1 或 2 块）。
+// 每次按各通道当前段剩余分组数的最小值调用多通道实现，某条消息结束后空出的通道立即装入下一条，
+// 长短不一的消息也能让通道保持满载。剩下的消息不足通道数一半时，改由单流实现逐条收尾
+
+// "single" 没有多通道核，每条消息直接调用 sha256()（按 sha256_select_impl 选的 scalar 或 shani）
+static const struct sha256_mb_impl sha256_mb_single = {
+    "single", NULL, 1, NULL,
+};
+
+// 按优先级排列，首次调用 sha256_multi 时选第一个可用的
+static const struct sha256_mb_impl *const sha256_mb_impls[] = {
+    &sha256_mb_avx2,
+    &sha256_mb_sse4,
+    &sha256_mb_single,
+};
+
+// 与 sha256_active 相同：原子读写，并发的首次选择用 CAS 发布
+static _Atomic(const struct sha256_mb_impl *) sha256_mb_active = NULL;
+
+// 有 SHA 扩展时单流的 shani 已经很快：4 通道在任何长度上都不如它，8 通道只在短消息上领先，
+// 超过 SHA256_MB_SHANI_MAX_LEN 的消息不进通道、直接逐条哈希
+#define SHA256_MB_SHANI_MAX_LEN 256
+
+static int sha256_mb_usable(const struct sha256_mb_impl *impl)
+{
+    return impl->available == NULL || impl->available();
+}
+
+static int sha256_mb_auto_usable(const struct sha256_mb_impl *impl)
+{
+    if (impl->compress != NULL && impl->lanes < SHA256_MAX_LANES && sha256_impl_get() == &sha256_impl_shani)
+    {
+        return 0;
+    }
+    return sha256_mb_usable(impl);
+}
+
+static const struct sha256_mb_impl *sha256_mb_get(void)
+{
+    const struct sha256_mb_impl *impl = atomic_load_explicit(&sha256_mb_active, memory_order_acquire);
+    if (impl == NULL)
+    {
+        const struct sha256_mb_impl *expected = NULL;
+        for (size_t i = 0; impl == NULL; i++)
+        {
+            if (sha256_mb_auto_usable(sha256_mb_impls[i]))
+            {
+                impl = sha256_mb_impls[i];
+            }
+        }
+        if (!atomic_compare_exchange_strong_explicit(&sha256_mb_active, &expected, impl, memory_order_acq_rel,
+                                                     memory_order_acquire))
+        {
+            impl = expected;
+        }
+    }
+    return impl;
+}
+
+int sha256_multi_select_impl(const char *name)
+{
+    for (size_t i = 0; i < sizeof(sha256_mb_impls) / sizeof(sha256_mb_impls[0]); i++)
+    {
+        const struct sha256_mb_impl *impl = sha256_mb_impls[i];
+        if (name == NULL ? sha256_mb_auto_usable(impl) : strcmp(impl->name, name) == 0)
+        {
+            if (!sha256_mb_usable(impl))
+            {
+                return -1;
+            }
+            atomic_store_explicit(&sha256_mb_active, impl, memory_order_release);
+            return 0;
+        }
+    }
+    return -1;
+}
+
+const char *sha256_multi_impl_name(void)
+{
+    return sha256_mb_get()->name;
+}
+
+struct sha256_lane {
+    sha256_job *job;                   // NULL 表示通道空闲
+    const byte *next;                  // 当前段下一个分组
+    size_t left;                       // 当前段剩余分组数
+    int in_tail;                       // 当前段是否为填充后的尾部
+    size_t tail_blocks;
+    byte tail[2 * SHA256_BLOCK_SIZE];
+};
+
+static void sha256_lane_start(struct sha256_lane *lane, uint32_t state[8][SHA256_MAX_LANES], size_t l,
+                              sha256_job *job)
+{
+    size_t full = job->len / SHA256_BLOCK_SIZE;
+    lane->job = job;
+    lane->tail_blocks = sha256_pad(lane->tail, job->data + full * SHA256_BLOCK_SIZE, job->len % SHA256_BLOCK_SIZE,
+                                   job->len);
+    lane->in_tail = (full == 0);
+    lane->next = lane->in_tail ? lane->tail : job->data;
+    lane->left = lane->in_tail ? lane->tail_blocks : full;
+    for (int i = 0; i < 8; i++)
+    {
+        state[i][l] = sha256_initial_hash[i];
+    }
+}
+
+// 通道前进 steps 个分组；消息结束时写出摘要并返回 1
+static int sha256_lane_advance(struct sha256_lane *lane, uint32_t state[8][SHA256_MAX_LANES], size_t l, size_t steps)
+{
+    lane->next += steps * SHA256_BLOCK_SIZE;
+    lane->left -= steps;
+    if (lane->left > 0)
+    {
+        return 0;
+    }
+    if (!lane->in_tail)
+    {
+        lane->in_tail = 1;
+        lane->next = lane->tail;
+        lane->left = lane->tail_blocks;
+        return 0;
+    }
+    uint32_t st[8];
+    for (int i = 0; i < 8; i++)
+    {
+        st[i] = state[i][l];
+    }
+    sha256_store_digest(st, lane->job->digest);
+    lane->job = NULL;
+    return 1;
+}
+
+// 单流实现处理通道上剩下的分组
+static void sha256_lane_finish(struct sha256_lane *lane, uint32_t state[8][SHA256_MAX_LANES], size_t l)
+{
+    const struct sha256_impl *impl = sha256_impl_get();
+    uint32_t st[8];
+    for (int i = 0; i < 8; i++)
+    {
+        st[i] = state[i][l];
+    }
+    impl->compress(st, lane->next, lane->left);
+    if (!lane->in_tail)
+    {
+        impl->compress(st, lane->tail, lane->tail_blocks);
+    }
+    sha256_store_digest(st, lane->job->digest);
+    lane->job = NULL;
+}
+
+void sha256_multi(sha256_job *jobs, size_t njobs)
+{
+    const struct sha256_mb_impl *mb = sha256_mb_get();
+    struct sha256_lane lanes[SHA256_MAX_LANES];
+    uint32_t state[8][SHA256_MAX_LANES];
+    const byte *ptrs[SHA256_MAX_LANES];
+    size_t active = 0, next = 0;
+    size_t max_len = (sha256_impl_get() == &sha256_impl_shani) ? SHA256_MB_SHANI_MAX_LEN : SIZE_MAX;
+
+    if (mb->compress == NULL)
+    {
+        for (size_t i = 0; i < njobs; i++)
+        {
+            sha256(jobs[i].data, jobs[i].len, jobs[i].digest);
+        }
+        return;
+    }
+    for (size_t l = 0; l < mb->lanes; l++)
+    {
+        lanes[l].job = NULL;
+    }
+
+    for (;;)
+    {
+        for (size_t l = 0; l < mb->lanes && next < njobs;)
+        {
+            sha256_job *job;
+            if (lanes[l].job != NULL)
+            {
+                l++;
+                continue;
+            }
+            job = &jobs[next++];
+            if (job->len > max_len) // 通道仍空闲，装入下一条
+            {
+                sha256(job->data, job->len, job->digest);
+                continue;
+            }
+            sha256_lane_start(&lanes[l], state, l, job);
+            active++;
+            l++;
+        }
+        if (next == njobs && active * 2 <= mb->lanes)
+        {
+            break;
+        }
+
+        size_t steps = SIZE_MAX;
+        const byte *any = NULL;
+        for (size_t l = 0; l < mb->lanes; l++)
+        {
+            if (lanes[l].job != NULL)
+            {
+                if (lanes[l].left < steps)
+                {
+                    steps = lanes[l].left;
+                }
+                any = lanes[l].next;
+            }
+        }
+        for (size_t l = 0; l < mb->lanes; l++) // 空闲通道重复计算某条有效通道的数据，结果丢弃
+        {
+            ptrs[l] = (lanes[l].job != NULL) ? lanes[l].next : any;
+        }
+        mb->compress(state, ptrs, steps);
+        for (size_t l = 0; l < mb->lanes; l++)
+        {
+            if (lanes[l].job != NULL)
+            {
+                active -= (size_t)sha256_lane_advance(&lanes[l], state, l, steps);
+            }
+        }
+    }
+
+    for (size_t l = 0; l < mb->lanes; l++)
+    {
+        if (lanes[l].job != NULL)
+        {
+            sha256_lane_finish(&lanes[l], state, l);
+        }
     }
+    secure_zero(lanes, sizeof(lanes));
+    secure_zero(state, sizeof(state));
 }
 
 void sha256_print(const byte *digest)
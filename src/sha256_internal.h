@@ -0,0 +1,51 @@
+#ifndef SHA256_INTERNAL_H
+#define SHA256_INTERNAL_H
+
+#include "crypto/sha256.h"
+
+// 以下宏只用到移位与按位运算，对 uint32_t 与 GCC 向量类型（多通道实现）同样适用
+// 循环右移n位  对应FIPS180-4的3.2.4
+#define ROTRIGHT(word, bits) (((word) >> (bits)) | ((word) << (32 - (bits))))
+
+// 选择函数 对应FIPS180-4的4.1.2：(x & y) ^ (~x & z)，此处为少一次运算的等价形式
+#define CH(x, y, z) ((z) ^ ((x) & ((y) ^ (z))))
+
+// 多路选择函数 对应FIPS180-4的4.1.2：(x & y) ^ (x & z) ^ (y & z)，此处为少一次运算的等价形式
+#define MAJ(x, y, z) (((x) & (y)) | ((z) & ((x) | (y))))
+
+// 大写希格玛函数 对应FIPS180-4的4.1.2 用于工作变量
+#define EP0(x) (ROTRIGHT(x, 2) ^ ROTRIGHT(x, 13) ^ ROTRIGHT(x, 22))
+#define EP1(x) (ROTRIGHT(x, 6) ^ ROTRIGHT(x, 11) ^ ROTRIGHT(x, 25))
+// 小写希格玛函数 对应FIPS180-4的4.1.2 用于消息调度
+#define SIG0(x) (ROTRIGHT(x, 7) ^ ROTRIGHT(x, 18) ^ ((x) >> 3))
+#define SIG1(x) (ROTRIGHT(x, 17) ^ ROTRIGHT(x, 19) ^ ((x) >> 10))
+
+// 压缩函数实现接口：首次哈希时按 CPU 选择一个，之后所有哈希（含 HMAC、PBKDF2、HKDF）都用它
+struct sha256_impl {
+    const char *name;
+    int (*available)(void); // 当前CPU是否支持，NULL表示总是可用
+    // 依次压缩 data 中连续的 nblocks 个 64 字节分组，state 为 8 个 32 位工作状态（主机字节序）
+    void (*compress)(uint32_t state[8], const byte *data, size_t nblocks);
+};
+
+extern const struct sha256_impl sha256_impl_scalar; // 可移植 C（sha256.c）
+extern const struct sha256_impl sha256_impl_shani;  // SHA 扩展指令（sha256_shani.c）
+extern const struct sha256_impl sha256_impl_avx2;   // AVX2 两分组消息调度 + BMI2（sha256_simd.c）
+extern const struct sha256_impl sha256_impl_ssse3;  // SSSE3 消息调度（sha256_simd.c）
+
+#define SHA256_MAX_LANES 8 // 多通道实现一次最多并行的消息数
+
+// 多通道压缩实现接口：每条 SIMD 通道处理一条独立的消息，sha256_multi 负责把消息排进通道
+struct sha256_mb_impl {
+    const char *name;
+    int (*available)(void);
+    size_t lanes;
+    // 通道 l 从 data[l] 起依次压缩 nblocks 个连续分组（l < lanes，不用的通道可指向任一有效数据）；
+    // state[i][l] 为通道 l 的第 i 个状态字，按字转置存放，便于整行载入向量寄存器
+    void (*compress)(uint32_t state[8][SHA256_MAX_LANES], const byte *const data[], size_t nblocks);
+};
+
+extern const struct sha256_mb_impl sha256_mb_sse4; // 4 通道 SSE4.1（sha256_mb.c）
+extern const struct sha256_mb_impl sha256_mb_avx2; // 8 通道 AVX2（sha256_mb.c）
+
+#endif // SHA256_INTERNAL_H
@@ -0,0 +1,136 @@
+#include "sha256_internal.h"
+#include "crypto/cpu.h"
+#include <string.h>
+
+// 多通道（multi-buffer）SHA-256：SIMD 寄存器的每个 32 位通道各算一条独立消息，4 或 8 条消息共用同一串指令
+// 轮函数与消息调度就是 sha256.c 中的宏，作用在 GCC 向量类型上（向量与标量混合运算时标量自动广播，
+// 轮常量直接取自 sha256_round_constants）；只有消息载入用 intrinsics 做 4x4 转置与字节序转换。
+// 单条消息的 SHA-256 是串行依赖链，多通道不缩短单条消息的延迟，提高的是许多短消息的总吞吐量
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+
+#define MB_SSE4_TARGET __attribute__((target("sse4.1")))
+#define MB_AVX2_TARGET __attribute__((target("avx2")))
+
+typedef uint32_t mb_v4 __attribute__((vector_size(16)));
+typedef uint32_t mb_v8 __attribute__((vector_size(32)));
+
+static int mb_sse4_available(void)
+{
+    return crypto_cpu_has(CPU_FEATURE_SSE41);
+}
+
+static int mb_avx2_available(void)
+{
+    return crypto_cpu_has(CPU_FEATURE_AVX2);
+}
+
+// 4 条通道各取 16 字节（第 4j..4j+3 个消息字），转置后 w[4j + k] 的通道 l 为通道 l 的第 4j+k 个字，并转为大端
+static inline __attribute__((always_inline)) MB_SSE4_TARGET void
+mb_load4(const byte *p0, const byte *p1, const byte *p2, const byte *p3, __m128i w[4])
+{
+    const __m128i bswap = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+    __m128i r0 = _mm_loadu_si128((const __m128i *)p0);
+    __m128i r1 = _mm_loadu_si128((const __m128i *)p1);
+    __m128i r2 = _mm_loadu_si128((const __m128i *)p2);
+    __m128i r3 = _mm_loadu_si128((const __m128i *)p3);
+    __m128i t0 = _mm_unpacklo_epi32(r0, r1);
+    __m128i t1 = _mm_unpackhi_epi32(r0, r1);
+    __m128i t2 = _mm_unpacklo_epi32(r2, r3);
+    __m128i t3 = _mm_unpackhi_epi32(r2, r3);
+    w[0] = _mm_shuffle_epi8(_mm_unpacklo_epi64(t0, t2), bswap);
+    w[1] = _mm_shuffle_epi8(_mm_unpackhi_epi64(t0, t2), bswap);
+    w[2] = _mm_shuffle_epi8(_mm_unpacklo_epi64(t1, t3), bswap);
+    w[3] = _mm_shuffle_epi8(_mm_unpackhi_epi64(t1, t3), bswap);
+}
+
+// 一个分组的 64 轮，s 与 w 为向量数组；消息调度在 16 个字的环形缓冲中原地展开
+#define MB_COMPRESS(V, s, w)                                                                            \
+    do {                                                                                                \
+        V a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];               \
+        _Pragma("GCC unroll 64")                                                                        \
+        for (int i = 0; i < 64; i++) {                                                                  \
+            if (i >= 16)                                                                                \
+                w[i & 15] += SIG1(w[(i - 2) & 15]) + w[(i - 7) & 15] + SIG0(w[(i - 15) & 15]);          \
+            V t1 = h + EP1(e) + CH(e, f, g) + sha256_round_constants[i] + w[i & 15];                    \
+            V t2 = EP0(a) + MAJ(a, b, c);                                                               \
+            h = g;                                                                                      \
+            g = f;                                                                                      \
+            f = e;                                                                                      \
+            e = d + t1;                                                                                 \
+            d = c;                                                                                      \
+            c = b;                                                                                      \
+            b = a;                                                                                      \
+            a = t1 + t2;                                                                                \
+        }                                                                                               \
+        s[0] += a;                                                                                      \
+        s[1] += b;                                                                                      \
+        s[2] += c;                                                                                      \
+        s[3] += d;                                                                                      \
+        s[4] += e;                                                                                      \
+        s[5] += f;                                                                                      \
+        s[6] += g;                                                                                      \
+        s[7] += h;                                                                                      \
+    } while (0)
+
+MB_SSE4_TARGET static void mb_sse4_compress(uint32_t state[8][SHA256_MAX_LANES], const byte *const data[],
+                                            size_t nblocks)
+{
+    mb_v4 s[8], w[16];
+    for (int i = 0; i < 8; i++) memcpy(&s[i], state[i], sizeof(s[i]));
+
+    for (size_t off = 0; off < nblocks * SHA256_BLOCK_SIZE; off += SHA256_BLOCK_SIZE) {
+        for (int j = 0; j < 16; j += 4) {
+            __m128i t[4];
+            mb_load4(data[0] + off + 4 * j, data[1] + off + 4 * j, data[2] + off + 4 * j, data[3] + off + 4 * j, t);
+            for (int k = 0; k < 4; k++) w[j + k] = (mb_v4)t[k];
+        }
+        MB_COMPRESS(mb_v4, s, w);
+    }
+    for (int i = 0; i < 8; i++) memcpy(state[i], &s[i], sizeof(s[i]));
+}
+
+// 通道 0-3 与 4-7 各转置一次，拼成 256 位向量
+MB_AVX2_TARGET static void mb_avx2_compress(uint32_t state[8][SHA256_MAX_LANES], const byte *const data[],
+                                            size_t nblocks)
+{
+    mb_v8 s[8], w[16];
+    for (int i = 0; i < 8; i++) memcpy(&s[i], state[i], sizeof(s[i]));
+
+    for (size_t off = 0; off < nblocks * SHA256_BLOCK_SIZE; off += SHA256_BLOCK_SIZE) {
+        for (int j = 0; j < 16; j += 4) {
+            __m128i lo[4], hi[4];
+            mb_load4(data[0] + off + 4 * j, data[1] + off + 4 * j, data[2] + off + 4 * j, data[3] + off + 4 * j, lo);
+            mb_load4(data[4] + off + 4 * j, data[5] + off + 4 * j, data[6] + off + 4 * j, data[7] + off + 4 * j, hi);
+            for (int k = 0; k < 4; k++) w[j + k] = (mb_v8)_mm256_set_m128i(hi[k], lo[k]);
+        }
+        MB_COMPRESS(mb_v8, s, w);
+    }
+    for (int i = 0; i < 8; i++) memcpy(state[i], &s[i], sizeof(s[i]));
+}
+
+const struct sha256_mb_impl sha256_mb_sse4 = {
+    "sse4", mb_sse4_available, 4, mb_sse4_compress,
+};
+
+const struct sha256_mb_impl sha256_mb_avx2 = {
+    "avx2", mb_avx2_available, 8, mb_avx2_compress,
+};
+
+#else
+
+static int mb_unavailable(void)
+{
+    return 0;
+}
+
+const struct sha256_mb_impl sha256_mb_sse4 = {
+    "sse4", mb_unavailable, 4, NULL,
+};
+
+const struct sha256_mb_impl sha256_mb_avx2 = {
+    "avx2", mb_unavailable, 8, NULL,
+};
+
+#endif
@@ -0,0 +1,82 @@
+#include "sha256_internal.h"
+#include "crypto/cpu.h"
+
+// SHA 扩展指令实现的 SHA-256 压缩    参考 Intel "Intel SHA Extensions" 白皮书
+// 状态保存在两个寄存器中，按指令要求的 ABEF / CDGH 排列；SHA256RNDS2 每条做两轮，
+// SHA256MSG1/MSG2 计算消息调度，与轮函数交错执行。分组循环在函数内部，状态只在首尾重排一次
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+
+#define SHANI_TARGET __attribute__((target("sha,sse4.1")))
+
+static int shani_available(void)
+{
+    return crypto_cpu_has(CPU_FEATURE_SHA | CPU_FEATURE_SSE41);
+}
+
+// 第 i 组四轮（轮 4i..4i+3）。msg[i % 4] 为 W[4i..4i+3]，同时推进后面分组的消息调度：
+// msg2 补完 W[4i+4..4i+7]，msg1 为 W[4i+12..4i+15] 准备 σ0 部分。i 在展开后是常量，条件在编译期消去
+#define SHANI_QUAD(i)                                                                               \
+    do {                                                                                            \
+        __m128i wk = _mm_add_epi32(msg[(i) % 4], _mm_loadu_si128((const __m128i *)(K + 4 * (i)))); \
+        cdgh = _mm_sha256rnds2_epu32(cdgh, abef, wk);                                               \
+        if ((i) >= 3 && (i) < 15) {                                                                 \
+            __m128i t = _mm_alignr_epi8(msg[(i) % 4], msg[((i) + 3) % 4], 4);                        \
+            msg[((i) + 1) % 4] = _mm_add_epi32(msg[((i) + 1) % 4], t);                               \
+            msg[((i) + 1) % 4] = _mm_sha256msg2_epu32(msg[((i) + 1) % 4], msg[(i) % 4]);             \
+        }                                                                                           \
+        abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(wk, 0x0e));                      \
+        if ((i) >= 1 && (i) < 13)                                                                   \
+            msg[((i) + 3) % 4] = _mm_sha256msg1_epu32(msg[((i) + 3) % 4], msg[(i) % 4]);             \
+    } while (0)
+
+SHANI_TARGET static void shani_compress(uint32_t state[8], const byte *data, size_t nblocks)
+{
+    const __m128i bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    const uint32_t *K = sha256_round_constants;
+    __m128i msg[4];
+
+    // state[0..3] = ABCD、state[4..7] = EFGH  ->  abef = {F,E,B,A}、cdgh = {H,G,D,C}（从低到高）
+    __m128i t = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)state), 0xb1);
+    __m128i cdgh = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)(state + 4)), 0x1b);
+    __m128i abef = _mm_alignr_epi8(t, cdgh, 8);
+    cdgh = _mm_blend_epi16(cdgh, t, 0xf0);
+
+    for (; nblocks > 0; nblocks--, data += SHA256_BLOCK_SIZE) {
+        __m128i abef_save = abef, cdgh_save = cdgh;
+        for (int j = 0; j < 4; j++)
+            msg[j] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)data + j), bswap);
+
+        SHANI_QUAD(0);  SHANI_QUAD(1);  SHANI_QUAD(2);  SHANI_QUAD(3);
+        SHANI_QUAD(4);  SHANI_QUAD(5);  SHANI_QUAD(6);  SHANI_QUAD(7);
+        SHANI_QUAD(8);  SHANI_QUAD(9);  SHANI_QUAD(10); SHANI_QUAD(11);
+        SHANI_QUAD(12); SHANI_QUAD(13); SHANI_QUAD(14); SHANI_QUAD(15);
+
+        abef = _mm_add_epi32(abef, abef_save);
+        cdgh = _mm_add_epi32(cdgh, cdgh_save);
+    }
+
+    // 还原为 ABCD / EFGH
+    t = _mm_shuffle_epi32(abef, 0x1b);
+    cdgh = _mm_shuffle_epi32(cdgh, 0xb1);
+    _mm_storeu_si128((__m128i *)state, _mm_blend_epi16(t, cdgh, 0xf0));
+    _mm_storeu_si128((__m128i *)(state + 4), _mm_alignr_epi8(cdgh, t, 8));
+}
+
+const struct sha256_impl sha256_impl_shani = {
+    "shani", shani_available, shani_compress,
+};
+
+#else
+
+static int shani_available(void)
+{
+    return 0;
+}
+
+const struct sha256_impl sha256_impl_shani = {
+    "shani", shani_available, NULL,
+};
+
+#endif
@@ -0,0 +1,208 @@
+#include "sha256_internal.h"
+#include "crypto/cpu.h"
+
+// 单流 SHA-256 的 SIMD 消息调度    参考 Intel "Fast SHA-256 Implementations on Intel Architecture Processors"
+// （sha256_sse4 / sha256_avx2_rorx）。轮函数仍是标量（8 个工作变量之间是串行依赖），
+// 消息调度用向量指令一次算 4 个字 W[t..t+3]：σ0 部分与 W[t-16]、W[t-7] 四个字一起算，
+// σ1 依赖 W[t-2]、W[t-1]，分两半完成（σ1(0) = 0，不需要掩码）。调度与轮函数交错写出，
+// 乱序执行把向量单元上的调度和整数单元上的轮函数重叠起来。
+//   ssse3：每个分组一遍调度，W+K 经栈上的小数组交给轮函数
+//   avx2 ：两个分组的调度放在 256 位寄存器的两个 128 位半部中一起算，第二个分组的 64 轮直接读取
+//          已算好的 W+K，不再有调度开销；开启 BMI2 后循环右移编译为不改标志位的 RORX
+// 适用于没有 SHA 扩展、又只有一条长消息（多通道用不上）的场合
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+
+#define SSSE3_TARGET __attribute__((target("ssse3")))
+#define AVX2_TARGET __attribute__((target("avx2,bmi2")))
+#define SIMD_INLINE(target) static inline __attribute__((always_inline)) target
+
+static int ssse3_available(void)
+{
+    return crypto_cpu_has(CPU_FEATURE_SSSE3);
+}
+
+static int avx2_available(void)
+{
+    return crypto_cpu_has(CPU_FEATURE_AVX2 | CPU_FEATURE_BMI2);
+}
+
+// 四轮，工作变量按轮依次轮换名字而不是搬移；wk 为 W[t..t+3] + K[t..t+3]
+#define SIMD_ROUND(a, b, c, d, e, f, g, h, wk)                       \
+    do {                                                             \
+        uint32_t t1 = (h) + EP1(e) + CH(e, f, g) + (wk);             \
+        uint32_t t2 = EP0(a) + MAJ(a, b, c);                         \
+        (d) += t1;                                                   \
+        (h) = t1 + t2;                                               \
+    } while (0)
+
+#define SIMD_ROUNDS4(a, b, c, d, e, f, g, h, wk)                     \
+    do {                                                             \
+        SIMD_ROUND(a, b, c, d, e, f, g, h, (wk)[0]);                 \
+        SIMD_ROUND(h, a, b, c, d, e, f, g, (wk)[1]);                 \
+        SIMD_ROUND(g, h, a, b, c, d, e, f, (wk)[2]);                 \
+        SIMD_ROUND(f, g, h, a, b, c, d, e, (wk)[3]);                 \
+    } while (0)
+
+// 第 4i..4i+3 轮：四轮一组，偶数组与奇数组的名字相差 4 个位置，两组之后恢复原位
+#define SIMD_GROUP(i, wk)                                            \
+    do {                                                             \
+        if ((i) % 2 == 0)                                            \
+            SIMD_ROUNDS4(a, b, c, d, e, f, g, h, wk);                \
+        else                                                         \
+            SIMD_ROUNDS4(e, f, g, h, a, b, c, d, wk);                \
+    } while (0)
+
+// 128 位：x0..x3 为 W[t-16..t-1]，返回 W[t..t+3]
+SIMD_INLINE(SSSE3_TARGET) __m128i rotr_128(__m128i x, int n)
+{
+    return _mm_or_si128(_mm_srli_epi32(x, n), _mm_slli_epi32(x, 32 - n));
+}
+
+SIMD_INLINE(SSSE3_TARGET) __m128i sched_128(__m128i x0, __m128i x1, __m128i x2, __m128i x3)
+{
+    __m128i w15 = _mm_alignr_epi8(x1, x0, 4); // W[t-15..t-12]
+    __m128i w7 = _mm_alignr_epi8(x3, x2, 4);  // W[t-7..t-4]
+    __m128i s0 = _mm_xor_si128(_mm_xor_si128(rotr_128(w15, 7), rotr_128(w15, 18)), _mm_srli_epi32(w15, 3));
+    __m128i t = _mm_add_epi32(_mm_add_epi32(x0, w7), s0);
+    __m128i y = _mm_srli_si128(x3, 8);        // W[t-2], W[t-1], 0, 0
+    t = _mm_add_epi32(t, _mm_xor_si128(_mm_xor_si128(rotr_128(y, 17), rotr_128(y, 19)), _mm_srli_epi32(y, 10)));
+    y = _mm_slli_si128(t, 8);                 // 0, 0, W[t], W[t+1]
+    return _mm_add_epi32(t, _mm_xor_si128(_mm_xor_si128(rotr_128(y, 17), rotr_128(y, 19)), _mm_srli_epi32(y, 10)));
+}
+
+// 256 位：两个 128 位半部各是一个分组，alignr 与字节移位本来就按 128 位半部分别进行
+SIMD_INLINE(AVX2_TARGET) __m256i rotr_256(__m256i x, int n)
+{
+    return _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - n));
+}
+
+SIMD_INLINE(AVX2_TARGET) __m256i sched_256(__m256i x0, __m256i x1, __m256i x2, __m256i x3)
+{
+    __m256i w15 = _mm256_alignr_epi8(x1, x0, 4);
+    __m256i w7 = _mm256_alignr_epi8(x3, x2, 4);
+    __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(rotr_256(w15, 7), rotr_256(w15, 18)), _mm256_srli_epi32(w15, 3));
+    __m256i t = _mm256_add_epi32(_mm256_add_epi32(x0, w7), s0);
+    __m256i y = _mm256_srli_si256(x3, 8);
+    t = _mm256_add_epi32(t, _mm256_xor_si256(_mm256_xor_si256(rotr_256(y, 17), rotr_256(y, 19)),
+                                             _mm256_srli_epi32(y, 10)));
+    y = _mm256_slli_si256(t, 8);
+    return _mm256_add_epi32(t, _mm256_xor_si256(_mm256_xor_si256(rotr_256(y, 17), rotr_256(y, 19)),
+                                                _mm256_srli_epi32(y, 10)));
+}
+
+// 一个分组：x[j] 为当前的 4 个消息字向量，每组四轮之前先把下一组要用的调度算出来
+SIMD_INLINE(SSSE3_TARGET) void ssse3_block(uint32_t state[8], const byte *data)
+{
+    const __m128i bswap = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+    const uint32_t *K = sha256_round_constants;
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    uint32_t wk[4] __attribute__((aligned(16)));
+    __m128i x[4];
+
+    for (int j = 0; j < 4; j++)
+        x[j] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)data + j), bswap);
+#pragma GCC unroll 16
+    for (int i = 0; i < 16; i++) {
+        _mm_store_si128((__m128i *)wk, _mm_add_epi32(x[i % 4], _mm_loadu_si128((const __m128i *)(K + 4 * i))));
+        if (i < 12)
+            x[i % 4] = sched_128(x[i % 4], x[(i + 1) % 4], x[(i + 2) % 4], x[(i + 3) % 4]);
+        SIMD_GROUP(i, wk);
+    }
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+SSSE3_TARGET static void ssse3_compress(uint32_t state[8], const byte *data, size_t nblocks)
+{
+    for (; nblocks > 0; nblocks--, data += SHA256_BLOCK_SIZE)
+        ssse3_block(state, data);
+}
+
+// 两个分组：第一个分组的轮函数与两个分组的调度交错，W+K 全部存入 wk（每组 8 个字：前 4 个属于第一个分组，
+// 后 4 个属于第二个分组），第二个分组随后只做轮函数
+SIMD_INLINE(AVX2_TARGET) void avx2_two_blocks(uint32_t state[8], const byte *data)
+{
+    const __m256i bswap = _mm256_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3,
+                                          12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+    const uint32_t *K = sha256_round_constants;
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    uint32_t wk[16 * 8] __attribute__((aligned(32)));
+    __m256i x[4];
+
+    for (int j = 0; j < 4; j++) {
+        __m256i m = _mm256_set_m128i(_mm_loadu_si128((const __m128i *)(data + SHA256_BLOCK_SIZE) + j),
+                                     _mm_loadu_si128((const __m128i *)data + j));
+        x[j] = _mm256_shuffle_epi8(m, bswap);
+    }
+#pragma GCC unroll 16
+    for (int i = 0; i < 16; i++) {
+        __m256i k = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)(K + 4 * i)));
+        _mm256_store_si256((__m256i *)(wk + 8 * i), _mm256_add_epi32(x[i % 4], k));
+        if (i < 12)
+            x[i % 4] = sched_256(x[i % 4], x[(i + 1) % 4], x[(i + 2) % 4], x[(i + 3) % 4]);
+        SIMD_GROUP(i, wk + 8 * i);
+    }
+    a = state[0] += a;
+    b = state[1] += b;
+    c = state[2] += c;
+    d = state[3] += d;
+    e = state[4] += e;
+    f = state[5] += f;
+    g = state[6] += g;
+    h = state[7] += h;
+
+#pragma GCC unroll 16
+    for (int i = 0; i < 16; i++)
+        SIMD_GROUP(i, wk + 8 * i + 4);
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+AVX2_TARGET static void avx2_compress(uint32_t state[8], const byte *data, size_t nblocks)
+{
+    for (; nblocks >= 2; nblocks -= 2, data += 2 * SHA256_BLOCK_SIZE)
+        avx2_two_blocks(state, data);
+    if (nblocks > 0)
+        ssse3_block(state, data);
+}
+
+const struct sha256_impl sha256_impl_ssse3 = {
+    "ssse3", ssse3_available, ssse3_compress,
+};
+
+const struct sha256_impl sha256_impl_avx2 = {
+    "avx2", avx2_available, avx2_compress,
+};
+
+#else
+
+static int simd_unavailable(void)
+{
+    return 0;
+}
+
+const struct sha256_impl sha256_impl_ssse3 = {
+    "ssse3", simd_unavailable, NULL,
+};
+
+const struct sha256_impl sha256_impl_avx2 = {
+    "avx2", simd_unavailable, NULL,
+};
+
+#endif
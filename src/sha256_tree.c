@@ -0,0 +1,153 @@
+#include "crypto/sha256_tree.h"
+#include "crypto/thread.h"
+
+// SHA-256 Merkle 树：叶子用 sha256_update 逐个哈希（经由当前选择的压缩实现），叶子按编号连续地分给各线程；
+// 内部节点每个只有两个分组，相对叶子可以忽略，由调用线程在叶子全部完成后逐层重算
+
+#define TREE_LEAF_PREFIX 0x00
+#define TREE_NODE_PREFIX 0x01
+
+struct tree_leaf_task {
+    const sha256_tree *tree;
+    size_t first;          // 本线程负责的第一个叶子编号
+    size_t count;
+    const byte *data;      // 第 first 个叶子的数据
+};
+
+static size_t tree_leaf_len(const sha256_tree *tree, size_t leaf)
+{
+    uint64_t rest = tree->total_len - (uint64_t)leaf * tree->leaf_size;
+    return rest < tree->leaf_size ? (size_t)rest : tree->leaf_size;
+}
+
+static void tree_hash(byte prefix, const byte *data, size_t len, byte out[SHA256_HASH_SIZE])
+{
+    sha256_ctx ctx;
+    sha256_init(&ctx);
+    sha256_update(&ctx, &prefix, 1);
+    if (len > 0)
+        sha256_update(&ctx, data, len);
+    sha256_final(&ctx, out);
+}
+
+static void tree_leaf_task(void *arg)
+{
+    struct tree_leaf_task *task = (struct tree_leaf_task *)arg;
+    const byte *p = task->data;
+    for (size_t i = task->first; i < task->first + task->count; i++) {
+        size_t len = tree_leaf_len(task->tree, i);
+        tree_hash(TREE_LEAF_PREFIX, p, len, task->tree->nodes[i]);
+        p += len;
+    }
+}
+
+// 叶子 [lo, hi) 已更新：逐层向上重算父节点 [lo/2, (hi-1)/2]，奇数个节点时最后一个原样上移
+static void tree_update_parents(sha256_tree *tree, size_t lo, size_t hi)
+{
+    size_t level = 0, width = tree->leaf_count;
+    while (width > 1) {
+        size_t next = level + width, next_width = (width + 1) / 2;
+        for (size_t p = lo / 2; p <= (hi - 1) / 2; p++) {
+            if (2 * p + 1 < width) {
+                tree_hash(TREE_NODE_PREFIX, tree->nodes[level + 2 * p], 2 * SHA256_HASH_SIZE, tree->nodes[next + p]);
+            } else {
+                memcpy(tree->nodes[next + p], tree->nodes[level + 2 * p], SHA256_HASH_SIZE);
+            }
+        }
+        lo /= 2;
+        hi = (hi - 1) / 2 + 1;
+        level = next;
+        width = next_width;
+    }
+}
+
+int sha256_tree_init(sha256_tree *tree, uint64_t total_len, size_t leaf_size)
+{
+    uint64_t leaves;
+    size_t nodes = 0;
+
+    memset(tree, 0, sizeof(*tree));
+    if (leaf_size == 0)
+        leaf_size = SHA256_TREE_DEFAULT_LEAF_SIZE;
+    leaves = total_len == 0 ? 1 : (total_len - 1) / leaf_size + 1;
+    if (leaves > SIZE_MAX / (2 * SHA256_HASH_SIZE))
+        return -1;
+    for (size_t width = (size_t)leaves; width > 1; width = (width + 1) / 2)
+        nodes += width;
+    nodes++; // 根
+
+    tree->nodes = (byte (*)[SHA256_HASH_SIZE])calloc(nodes, SHA256_HASH_SIZE);
+    if (tree->nodes == NULL)
+        return -1;
+    tree->total_len = total_len;
+    tree->leaf_size = leaf_size;
+    tree->leaf_count = (size_t)leaves;
+    tree->node_count = nodes;
+    return 0;
+}
+
+int sha256_tree_update(sha256_tree *tree, size_t first_leaf, const byte *data, size_t len, int threads)
+{
+    uint64_t start, end;
+    size_t count;
+
+    if (tree->nodes == NULL || first_leaf >= tree->leaf_count)
+        return -1;
+    start = (uint64_t)first_leaf * tree->leaf_size;
+    end = start + len;
+    if (end > tree->total_len || (len % tree->leaf_size != 0 && end != tree->total_len))
+        return -1;
+    count = end == tree->total_len ? tree->leaf_count - first_leaf : len / tree->leaf_size;
+    if (count == 0)
+        return -1;
+
+    if (threads <= 0)
+        threads = crypto_cpu_count();
+    if ((size_t)threads > count)
+        threads = (int)count;
+    struct tree_leaf_task *tasks = (struct tree_leaf_task *)malloc(sizeof(struct tree_leaf_task) * threads);
+    if (tasks == NULL) {
+        struct tree_leaf_task task = { tree, first_leaf, count, data };
+        tree_leaf_task(&task); // 内存不足时在当前线程完成
+    } else {
+        size_t done = 0;
+        for (int t = 0; t < threads; t++) {
+            size_t n = count * (t + 1) / threads - done;
+            tasks[t].tree = tree;
+            tasks[t].first = first_leaf + done;
+            tasks[t].count = n;
+            tasks[t].data = data + done * tree->leaf_size;
+            done += n;
+        }
+        crypto_run_parallel(tree_leaf_task, tasks, sizeof(struct tree_leaf_task), threads);
+        free(tasks);
+    }
+
+    tree_update_parents(tree, first_leaf, first_leaf + count);
+    return 0;
+}
+
+void sha256_tree_root(const sha256_tree *tree, byte root[SHA256_HASH_SIZE])
+{
+    memcpy(root, tree->nodes[tree->node_count - 1], SHA256_HASH_SIZE);
+}
+
+void sha256_tree_free(sha256_tree *tree)
+{
+    free(tree->nodes);
+    memset(tree, 0, sizeof(*tree));
+}
+
+int sha256_tree_digest(const byte *data, size_t len, size_t leaf_size, int threads, byte root[SHA256_HASH_SIZE])
+{
+    sha256_tree tree;
+    if (sha256_tree_init(&tree, len, leaf_size) != 0)
+        return -1;
+    if (sha256_tree_update(&tree, 0, data, len, threads) != 0) {
+        sha256_tree_free(&tree);
+        return -1;
+    }
+    sha256_tree_root(&tree, root);
+    sha256_tree_free(&tree);
+    return 0;
+}
@@ -0,0 +1,102 @@
+#include "crypto/thread.h"
+#include <stdlib.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+// 线程入口需要的包装：系统线程函数签名与 crypto_task_fn 不同
+struct task_slot {
+    crypto_task_fn fn;
+    void *arg;
+};
+
+#ifdef _WIN32
+static DWORD WINAPI task_entry(LPVOID p)
+{
+    struct task_slot *slot = (struct task_slot *)p;
+    slot->fn(slot->arg);
+    return 0;
+}
+#else
+static void *task_entry(void *p)
+{
+    struct task_slot *slot = (struct task_slot *)p;
+    slot->fn(slot->arg);
+    return NULL;
+}
+#endif
+
+int crypto_run_parallel(crypto_task_fn fn, void *args, size_t arg_size, int count)
+{
+    if (fn == NULL || count <= 0) {
+        return -1; // 参数无效
+    }
+    if (count == 1) {
+        fn(args);
+        return 0;
+    }
+
+    struct task_slot *slots = (struct task_slot *)malloc(sizeof(struct task_slot) * count);
+#ifdef _WIN32
+    HANDLE *threads = (HANDLE *)malloc(sizeof(HANDLE) * count);
+#else
+    pthread_t *threads = (pthread_t *)malloc(sizeof(pthread_t) * count);
+#endif
+    int *started = (int *)calloc(count, sizeof(int));
+    if (slots == NULL || threads == NULL || started == NULL) {
+        // 内存不足时退化为串行执行
+        free(slots);
+        free(threads);
+        free(started);
+        for (int i = 0; i < count; i++) {
+            fn((char *)args + (size_t)i * arg_size);
+        }
+        return -1;
+    }
+
+    int ret = 0;
+    for (int i = 0; i < count; i++) {
+        slots[i].fn = fn;
+        slots[i].arg = (char *)args + (size_t)i * arg_size;
+#ifdef _WIN32
+        threads[i] = CreateThread(NULL, 0, task_entry, &slots[i], 0, NULL);
+        started[i] = (threads[i] != NULL);
+#else
+        started[i] = (pthread_create(&threads[i], NULL, task_entry, &slots[i]) == 0);
+#endif
+        if (!started[i]) {
+            fn(slots[i].arg); // 线程创建失败，在当前线程中完成该任务
+            ret = -1;
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (!started[i]) continue;
+#ifdef _WIN32
+        WaitForSingleObject(threads[i], INFINITE);
+        CloseHandle(threads[i]);
+#else
+        pthread_join(threads[i], NULL);
+#endif
+    }
+
+    free(slots);
+    free(threads);
+    free(started);
+    return ret;
+}
+
+int crypto_cpu_count(void)
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+#endif
+}
@@ -0,0 +1,34 @@
+#ifndef TEST_BENCH_H
+#define TEST_BENCH_H
+
+#include <stdio.h>
+#include <stddef.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+// 基准测试用的墙钟计时（秒），多线程基准不能用 clock()
+static double bench_now(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER freq, now;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (double)now.QuadPart / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}
+
+// 打印一行吞吐量结果
+static void bench_report(const char *label, size_t bytes, double seconds)
+{
+    double mbps = seconds > 0 ? (double)bytes / seconds / (1024.0 * 1024.0) : 0.0;
+    printf("  %-28s %10.1f MB/s\n", label, mbps);
+}
+
+#endif // TEST_BENCH_H
@@ -0,0 +1,298 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "crypto/gcm.h"
+#include "crypto/gcm_siv.h"
+#include "crypto/thread.h"
+#include "crypto/hmac.h"
+#include "bench.h"
+#include "vectors.h"
+
+// GCM基准：对每种可用的 GHASH 实现测 GCM 加密与单独 GHASH（只有 AAD 的消息）的吞吐量，
+// 另测默认实现下单条大消息分段多线程加解密随线程数的扩展、伪造记录的拒绝速率，
+// 以及 16 B - 16 KB 小记录逐条调用与批量接口的每秒记录数、GMAC 与 HMAC-SHA256 的认证吞吐量，
+// 以及 AES-GCM-SIV 与 GCM 的对比
+
+#define BENCH_BYTES (8 * 1024 * 1024)
+
+static const char *const GHASH_IMPLS[] = { "table", "clmul" };
+
+static void bench_ghash_impl(const char *name, const byte *buf, byte *out)
+{
+    aes_gcm_ctx ctx;
+    byte tag[GCM_TAG_SIZE];
+    double t0, t1;
+
+    if (aes_gcm_key_init_ghash(&ctx, AES128_KEY, 16, name) != 0) {
+        printf("[%s] not supported on this CPU\n", name);
+        return;
+    }
+    printf("[%s]\n", name);
+
+    t0 = bench_now();
+    aes_gcm_encrypt_ctx(&ctx, GCM_TC4_IV, GCM_IV_SIZE, buf, BENCH_BYTES, NULL, 0, out, tag);
+    t1 = bench_now();
+    bench_report("GCM encrypt", BENCH_BYTES, t1 - t0);
+
+    t0 = bench_now();
+    aes_gcm_decrypt_ctx(&ctx, GCM_TC4_IV, GCM_IV_SIZE, out, BENCH_BYTES, NULL, 0, out, tag);
+    t1 = bench_now();
+    bench_report("GCM decrypt", BENCH_BYTES, t1 - t0);
+
+    t0 = bench_now();
+    aes_gcm_encrypt_ctx(&ctx, GCM_TC4_IV, GCM_IV_SIZE, NULL, 0, buf, BENCH_BYTES, NULL, tag);
+    t1 = bench_now();
+    bench_report("GHASH (AAD only)", BENCH_BYTES, t1 - t0);
+
+    aes_gcm_key_clear(&ctx);
+}
+
+// 每秒处理的记录数
+static void report_pps(const char *label, size_t packets, double seconds)
+{
+    double pps = seconds > 0 ? (double)packets / seconds : 0.0;
+    printf("  %-28s %10.0f packets/s\n", label, pps);
+}
+
+// 伪造记录（标签错误）：普通解密先解密再比较并擦除输出，先认证后解密只做 GHASH
+static void bench_forged(const byte *buf, byte *out)
+{
+    static const size_t sizes[] = { 64, 1500, 16384 };
+    aes_gcm_ctx ctx;
+    byte tag[GCM_TAG_SIZE];
+    char label[64];
+    double t0, t1;
+
+    aes_gcm_key_init(&ctx, AES128_KEY, 16);
+    printf("[forged packets, %s]\n", aes_gcm_ghash_name(&ctx));
+    for (size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+        size_t packets = BENCH_BYTES / sizes[k];
+        aes_gcm_encrypt_ctx(&ctx, GCM_TC4_IV, GCM_IV_SIZE, buf, sizes[k], NULL, 0, out, tag);
+        tag[0] ^= 1;
+
+        t0 = bench_now();
+        for (size_t i = 0; i < packets; i++)
+            aes_gcm_decrypt_ctx(&ctx, GCM_TC4_IV, GCM_IV_SIZE, buf + i * sizes[k], sizes[k], NULL, 0, out, tag);
+        t1 = bench_now();
+        snprintf(label, sizeof(label), "%zu B decrypt+wipe", sizes[k]);
+        report_pps(label, packets, t1 - t0);
+
+        t0 = bench_now();
+        for (size_t i = 0; i < packets; i++)
+            aes_gcm_verify_decrypt_ctx(&ctx, GCM_TC4_IV, GCM_IV_SIZE, buf + i * sizes[k], sizes[k], NULL, 0, out,
+                                       tag);
+        t1 = bench_now();
+        snprintf(label, sizeof(label), "%zu B verify-first", sizes[k]);
+        report_pps(label, packets, t1 - t0);
+    }
+    aes_gcm_key_clear(&ctx);
+}
+
+// 小记录：逐条调用 aes_gcm_encrypt_ctx 与每 BATCH_JOBS 条调用一次 aes_gcm_encrypt_batch
+#define BATCH_JOBS 64
+
+static void bench_batch(const byte *buf, byte *out)
+{
+    static const size_t sizes[] = { 16, 64, 256, 576, 1500, 4096, 16384 };
+    static byte tags[BATCH_JOBS][GCM_TAG_SIZE];
+    static byte ivs[BATCH_JOBS][GCM_IV_SIZE];
+    aes_gcm_job jobs[BATCH_JOBS];
+    aes_gcm_ctx ctx;
+    char label[64];
+    double t0, t1;
+
+    aes_gcm_key_init(&ctx, AES128_KEY, 16);
+    printf("[small packets, %s, %d-byte AAD]\n", aes_gcm_ghash_name(&ctx), 13);
+    for (size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+        size_t len = sizes[k];
+        size_t packets = (BENCH_BYTES / len) / BATCH_JOBS * BATCH_JOBS;
+        if (packets > 1 << 18) packets = 1 << 18;
+
+        t0 = bench_now();
+        for (size_t i = 0; i < packets; i++) {
+            size_t off = (i % BATCH_JOBS) * len;
+            aes_gcm_encrypt_ctx(&ctx, GCM_TC4_IV, GCM_IV_SIZE, buf + off, len, buf, 13, out + off, tags[i % BATCH_JOBS]);
+        }
+        t1 = bench_now();
+        snprintf(label, sizeof(label), "%zu B one at a time", len);
+        report_pps(label, packets, t1 - t0);
+
+        for (size_t j = 0; j < BATCH_JOBS; j++) {
+            memcpy(ivs[j], GCM_TC4_IV, GCM_IV_SIZE);
+            ivs[j][0] = (byte)j;
+            jobs[j].iv = ivs[j];
+            jobs[j].iv_len = GCM_IV_SIZE;
+            jobs[j].aad = buf;
+            jobs[j].aad_len = 13;
+            jobs[j].input = buf + j * len;
+            jobs[j].output = out + j * len;
+            jobs[j].length = len;
+            jobs[j].tag = tags[j];
+        }
+        t0 = bench_now();
+        for (size_t i = 0; i < packets; i += BATCH_JOBS)
+            aes_gcm_encrypt_batch(&ctx, jobs, BATCH_JOBS);
+        t1 = bench_now();
+        snprintf(label, sizeof(label), "%zu B batch of %d", len, BATCH_JOBS);
+        report_pps(label, packets, t1 - t0);
+    }
+    aes_gcm_key_clear(&ctx);
+}
+
+// 只认证：各 GHASH 实现的 GMAC 与 hmac_sha256，每种消息长度共处理 BENCH_BYTES 字节
+static void bench_gmac(const byte *buf)
+{
+    static const size_t sizes[] = { 64, 1500, 16384, 1024 * 1024 };
+    byte tag[32];
+    char label[64];
+    double t0, t1;
+
+    for (size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+        size_t len = sizes[k];
+        size_t count = BENCH_BYTES / len;
+        printf("[authenticate only, %zu B messages]\n", len);
+        for (size_t i = 0; i < sizeof(GHASH_IMPLS) / sizeof(GHASH_IMPLS[0]); i++) {
+            aes_gcm_ctx ctx;
+            if (aes_gcm_key_init_ghash(&ctx, AES128_KEY, 16, GHASH_IMPLS[i]) != 0) continue;
+            t0 = bench_now();
+            for (size_t j = 0; j < count; j++)
+                aes_gmac_ctx(&ctx, GCM_TC4_IV, GCM_IV_SIZE, buf + j * len, len, tag);
+            t1 = bench_now();
+            snprintf(label, sizeof(label), "GMAC [%s]", GHASH_IMPLS[i]);
+            bench_report(label, count * len, t1 - t0);
+            aes_gcm_key_clear(&ctx);
+        }
+        t0 = bench_now();
+        for (size_t j = 0; j < count; j++)
+            hmac_sha256(GCM_TC16_KEY, sizeof(GCM_TC16_KEY), buf + j * len, len, tag);
+        t1 = bench_now();
+        bench_report("HMAC-SHA256", count * len, t1 - t0);
+    }
+}
+
+// AES-GCM-SIV：大消息吞吐量与 1500 B 记录的每秒记录数，同一 GHASH 实现下与 GCM 对比
+static void bench_siv(const byte *buf, byte *out)
+{
+    const size_t small = 1500;
+    const size_t packets = BENCH_BYTES / small;
+    byte tag[GCM_TAG_SIZE];
+    char label[64];
+    double t0, t1;
+
+    for (size_t i = 0; i < sizeof(GHASH_IMPLS) / sizeof(GHASH_IMPLS[0]); i++) {
+        aes_gcm_ctx gcm;
+        aes_gcm_siv_ctx siv;
+        if (aes_gcm_siv_key_init_ghash(&siv, GCM_TC16_KEY, 16, GHASH_IMPLS[i]) != 0) continue;
+        aes_gcm_key_init_ghash(&gcm, GCM_TC16_KEY, 16, GHASH_IMPLS[i]);
+        printf("[GCM-SIV vs GCM, %s]\n", GHASH_IMPLS[i]);
+
+        t0 = bench_now();
+        aes_gcm_encrypt_ctx(&gcm, GCM_TC4_IV, GCM_IV_SIZE, buf, BENCH_BYTES, NULL, 0, out, tag);
+        t1 = bench_now();
+        bench_report("GCM encrypt", BENCH_BYTES, t1 - t0);
+        t0 = bench_now();
+        aes_gcm_siv_encrypt_ctx(&siv, GCM_TC4_IV, buf, BENCH_BYTES, NULL, 0, out, tag);
+        t1 = bench_now();
+        bench_report("GCM-SIV encrypt", BENCH_BYTES, t1 - t0);
+        t0 = bench_now();
+        aes_gcm_siv_decrypt_ctx(&siv, GCM_TC4_IV, out, BENCH_BYTES, NULL, 0, out, tag);
+        t1 = bench_now();
+        bench_report("GCM-SIV decrypt", BENCH_BYTES, t1 - t0);
+
+        t0 = bench_now();
+        for (size_t j = 0; j < packets; j++)
+            aes_gcm_encrypt_ctx(&gcm, GCM_TC4_IV, GCM_IV_SIZE, buf + j * small, small, buf, 13, out, tag);
+        t1 = bench_now();
+        snprintf(label, sizeof(label), "GCM %zu B", small);
+        report_pps(label, packets, t1 - t0);
+        t0 = bench_now();
+        for (size_t j = 0; j < packets; j++)
+            aes_gcm_siv_encrypt_ctx(&siv, GCM_TC4_IV, buf + j * small, small, buf, 13, out, tag);
+        t1 = bench_now();
+        snprintf(label, sizeof(label), "GCM-SIV %zu B", small);
+        report_pps(label, packets, t1 - t0);
+
+        aes_gcm_key_clear(&gcm);
+        aes_gcm_siv_key_clear(&siv);
+    }
+}
+
+#define PARALLEL_BYTES (64 * 1024 * 1024)
+
+static void bench_parallel(void)
+{
+    aes_gcm_ctx ctx;
+    byte tag[GCM_TAG_SIZE];
+    byte *buf = (byte *)malloc(PARALLEL_BYTES);
+    byte *out = (byte *)malloc(PARALLEL_BYTES);
+    char label[64];
+    double t0, t1;
+
+    if (buf == NULL || out == NULL) {
+        printf("Memory allocation failed\n");
+        free(buf);
+        free(out);
+        return;
+    }
+    memset(buf, 0x5a, PARALLEL_BYTES);
+    memset(out, 0, PARALLEL_BYTES);
+    aes_gcm_key_init(&ctx, AES128_KEY, 16);
+    printf("[parallel, %s, %d MB, %d CPUs]\n", aes_gcm_ghash_name(&ctx), PARALLEL_BYTES / (1024 * 1024),
+           crypto_cpu_count());
+
+    aes_gcm_encrypt_parallel(&ctx, GCM_TC4_IV, GCM_IV_SIZE, buf, PARALLEL_BYTES, NULL, 0, out, tag, 1); // 预热
+
+    const int thread_counts[] = { 1, 2, 4, 8, 16 };
+    for (size_t t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]); t++) {
+        t0 = bench_now();
+        aes_gcm_encrypt_parallel(&ctx, GCM_TC4_IV, GCM_IV_SIZE, buf, PARALLEL_BYTES, NULL, 0, out, tag,
+                                 thread_counts[t]);
+        t1 = bench_now();
+        snprintf(label, sizeof(label), "GCM encrypt (%d threads)", thread_counts[t]);
+        bench_report(label, PARALLEL_BYTES, t1 - t0);
+
+        t0 = bench_now();
+        aes_gcm_decrypt_parallel(&ctx, GCM_TC4_IV, GCM_IV_SIZE, out, PARALLEL_BYTES, NULL, 0, out, tag,
+                                 thread_counts[t]);
+        t1 = bench_now();
+        snprintf(label, sizeof(label), "GCM decrypt (%d threads)", thread_counts[t]);
+        bench_report(label, PARALLEL_BYTES, t1 - t0);
+    }
+
+    aes_gcm_key_clear(&ctx);
+    free(buf);
+    free(out);
+}
+
+int main(int argc, char **argv)
+{
+    byte *buf = (byte *)malloc(BENCH_BYTES);
+    byte *out = (byte *)malloc(BENCH_BYTES);
+    if (buf == NULL || out == NULL) {
+        printf("Memory allocation failed\n");
+        return 1;
+    }
+    for (size_t i = 0; i < BENCH_BYTES; i++) buf[i] = (byte)(i * 131);
+    memset(out, 0, BENCH_BYTES); // 预先触发缺页，避免计入第一项测试
+
+    printf("AES-128-GCM benchmark, %d MB per test\n", BENCH_BYTES / (1024 * 1024));
+    for (size_t i = 0; i < sizeof(GHASH_IMPLS) / sizeof(GHASH_IMPLS[0]); i++) {
+        // 可在命令行指定只测某个 GHASH 实现，或用 "gmac"/"siv"/"batch"/"forged"/"parallel" 只测对应部分
+        if (argc > 1 && strcmp(argv[1], GHASH_IMPLS[i]) != 0) continue;
+        bench_ghash_impl(GHASH_IMPLS[i], buf, out);
+    }
+    if (argc <= 1 || strcmp(argv[1], "gmac") == 0)
+        bench_gmac(buf);
+    if (argc <= 1 || strcmp(argv[1], "siv") == 0)
+        bench_siv(buf, out);
+    if (argc <= 1 || strcmp(argv[1], "batch") == 0)
+        bench_batch(buf, out);
+    if (argc <= 1 || strcmp(argv[1], "forged") == 0)
+        bench_forged(buf, out);
+    if (argc <= 1 || strcmp(argv[1], "parallel") == 0)
+        bench_parallel();
+
+    free(buf);
+    free(out);
+    return 0;
+}
@@ -0,0 +1,176 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "crypto/sha256.h"
+#include "crypto/hmac.h"
+#include "crypto/kdf.h"
+#include "crypto/sha256_tree.h"
+#include "crypto/thread.h"
+#include "bench.h"
+
+// SHA-256基准：对每种可用的压缩实现测大消息吞吐量、短消息每秒哈希数、HMAC 与 PBKDF2 的速率，
+// 多通道实现批量哈希短消息的每秒哈希数，以及 Merkle 树摘要随线程数的吞吐量
+
+#define BENCH_BYTES (8 * 1024 * 1024)
+#define BENCH_PBKDF2_ITERATIONS 20000
+
+static const char *const SHA256_IMPLS[] = { "scalar", "ssse3", "avx2", "shani" };
+
+static void report_rate(const char *label, size_t count, double seconds, const char *unit)
+{
+    double rate = seconds > 0 ? (double)count / seconds : 0.0;
+    printf("  %-28s %10.0f %s\n", label, rate, unit);
+}
+
+static void bench_impl(const char *name, const byte *buf)
+{
+    static const size_t sizes[] = { 64, 1500 };
+    byte digest[SHA256_HASH_SIZE], dk[32];
+    char label[64];
+    double t0, t1;
+
+    if (sha256_select_impl(name) != 0) {
+        printf("[%s] not supported on this CPU\n", name);
+        return;
+    }
+    printf("[%s]\n", name);
+
+    t0 = bench_now();
+    sha256(buf, BENCH_BYTES, digest);
+    t1 = bench_now();
+    bench_report("SHA-256 8 MB", BENCH_BYTES, t1 - t0);
+
+    for (size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+        size_t len = sizes[k];
+        size_t count = BENCH_BYTES / len;
+        t0 = bench_now();
+        for (size_t j = 0; j < count; j++) sha256(buf + j * len, len, digest);
+        t1 = bench_now();
+        snprintf(label, sizeof(label), "SHA-256 %zu B", len);
+        report_rate(label, count, t1 - t0, "hashes/s");
+
+        t0 = bench_now();
+        for (size_t j = 0; j < count; j++) hmac_sha256(buf, 32, buf + j * len, len, digest);
+        t1 = bench_now();
+        snprintf(label, sizeof(label), "HMAC-SHA256 %zu B", len);
+        report_rate(label, count, t1 - t0, "tags/s");
+    }
+
+    t0 = bench_now();
+    pbkdf2_hmac_sha256(buf, 16, buf + 16, 16, BENCH_PBKDF2_ITERATIONS, sizeof(dk), dk);
+    t1 = bench_now();
+    report_rate("PBKDF2 iterations", BENCH_PBKDF2_ITERATIONS, t1 - t0, "iter/s");
+}
+
+// 多通道：同样长度的一批独立消息，各多通道实现与逐条调用（single）的每秒哈希数；
+// 单流实现分别取 scalar（相当于没有 SHA 扩展的 CPU）与自动选择的实现
+#define MULTI_JOBS 64
+
+static void bench_multi(const byte *buf)
+{
+    static const size_t sizes[] = { 32, 64, 256, 1500 };
+    static const char *const single_impls[] = { "scalar", NULL };
+    static const char *const multi_impls[] = { "single", "sse4", "avx2" };
+    static byte digests[MULTI_JOBS][SHA256_HASH_SIZE];
+    sha256_job jobs[MULTI_JOBS];
+    char label[64];
+    double t0, t1;
+
+    for (size_t s = 0; s < sizeof(single_impls) / sizeof(single_impls[0]); s++) {
+        if (sha256_select_impl(single_impls[s]) != 0) continue;
+        printf("[multi-buffer, single-stream %s]\n", sha256_impl_name());
+        for (size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+            size_t len = sizes[k];
+            size_t batches = BENCH_BYTES / (len * MULTI_JOBS);
+            for (size_t j = 0; j < MULTI_JOBS; j++) {
+                jobs[j].len = len;
+                jobs[j].digest = digests[j];
+            }
+            for (size_t m = 0; m < sizeof(multi_impls) / sizeof(multi_impls[0]); m++) {
+                if (sha256_multi_select_impl(multi_impls[m]) != 0) continue;
+                t0 = bench_now();
+                for (size_t b = 0; b < batches; b++) {
+                    for (size_t j = 0; j < MULTI_JOBS; j++) jobs[j].data = buf + (b * MULTI_JOBS + j) * len;
+                    sha256_multi(jobs, MULTI_JOBS);
+                }
+                t1 = bench_now();
+                snprintf(label, sizeof(label), "%zu B x%d [%s]", len, MULTI_JOBS, multi_impls[m]);
+                report_rate(label, batches * MULTI_JOBS, t1 - t0, "hashes/s");
+            }
+        }
+    }
+    sha256_select_impl(NULL);
+    sha256_multi_select_impl(NULL);
+}
+
+// Merkle 树：256 MB 数据、默认 1 MB 叶子，线程数从 1 翻倍到 CPU 核数的两倍，报告 GB/s 与相对单线程的加速比；
+// 另测修改一个叶子后增量更新的耗时
+#define TREE_BENCH_BYTES (256 * 1024 * 1024)
+
+static void bench_tree(void)
+{
+    byte *data = (byte *)malloc(TREE_BENCH_BYTES);
+    byte root[SHA256_HASH_SIZE];
+    int max_threads = 2 * crypto_cpu_count();
+    double base = 0.0, t0, t1;
+    sha256_tree tree;
+
+    if (data == NULL) {
+        printf("Memory allocation failed\n");
+        return;
+    }
+    for (size_t i = 0; i < TREE_BENCH_BYTES; i++) data[i] = (byte)(i * 7);
+    if (max_threads < 8) max_threads = 8;
+
+    printf("[tree, %s, %d MB, %d KB leaves, %d CPUs]\n", sha256_impl_name(), TREE_BENCH_BYTES >> 20,
+           SHA256_TREE_DEFAULT_LEAF_SIZE >> 10, crypto_cpu_count());
+    t0 = bench_now();
+    sha256(data, TREE_BENCH_BYTES, root);
+    t1 = bench_now();
+    printf("  %-28s %10.2f GB/s\n", "sha256 (serial)", TREE_BENCH_BYTES / (t1 - t0) / 1e9);
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        char label[64];
+        t0 = bench_now();
+        sha256_tree_digest(data, TREE_BENCH_BYTES, 0, threads, root);
+        t1 = bench_now();
+        if (threads == 1) base = t1 - t0;
+        snprintf(label, sizeof(label), "tree %d thread%s", threads, threads > 1 ? "s" : "");
+        printf("  %-28s %10.2f GB/s  x%.2f\n", label, TREE_BENCH_BYTES / (t1 - t0) / 1e9, base / (t1 - t0));
+    }
+
+    if (sha256_tree_init(&tree, TREE_BENCH_BYTES, 0) == 0) {
+        sha256_tree_update(&tree, 0, data, TREE_BENCH_BYTES, 0);
+        data[TREE_BENCH_BYTES / 2] ^= 1;
+        t0 = bench_now();
+        sha256_tree_update(&tree, (TREE_BENCH_BYTES / 2) / tree.leaf_size,
+                           data + TREE_BENCH_BYTES / 2 / tree.leaf_size * tree.leaf_size, tree.leaf_size, 1);
+        t1 = bench_now();
+        printf("  %-28s %10.3f ms\n", "update one leaf", (t1 - t0) * 1e3);
+        sha256_tree_free(&tree);
+    }
+    free(data);
+}
+
+int main(int argc, char **argv)
+{
+    byte *buf = (byte *)malloc(BENCH_BYTES);
+    if (buf == NULL) {
+        printf("Memory allocation failed\n");
+        return 1;
+    }
+    for (size_t i = 0; i < BENCH_BYTES; i++) buf[i] = (byte)(i * 7);
+
+    printf("SHA-256 benchmark\n");
+    for (size_t i = 0; i < sizeof(SHA256_IMPLS) / sizeof(SHA256_IMPLS[0]); i++) {
+        if (argc > 1 && strcmp(argv[1], SHA256_IMPLS[i]) != 0) continue;
+        bench_impl(SHA256_IMPLS[i], buf);
+    }
+    sha256_select_impl(NULL);
+    if (argc <= 1 || strcmp(argv[1], "multi") == 0)
+        bench_multi(buf);
+    if (argc <= 1 || strcmp(argv[1], "tree") == 0)
+        bench_tree();
+
+    free(buf);
+    return 0;
+}
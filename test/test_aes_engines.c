@@ -0,0 +1,274 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "AES/AESEncryption.h"
+#include "AES/AESDecryption.h"
+#include "vectors.h"
+
+// 对每个可用的AES引擎和每种密钥长度：FIPS-197 单分组向量、SP 800-38A CBC/CTR 向量，以及与参考实现的随机交叉比对；
+// CTR 另测任意字节偏移的随机访问与计数器跨 64 位字的进位
+
+#define RANDOM_BLOCKS 1024
+
+struct key_size_case {
+    const char *label;
+    const byte *key;
+    size_t key_len;
+    const byte *plaintext, *ciphertext;    // FIPS-197 单分组向量
+    const byte *cbc_key, *cbc_ciphertext;  // SP 800-38A CBC 向量
+    const byte *ctr_ciphertext;            // SP 800-38A CTR 向量（密钥同 CBC）
+};
+
+static const struct key_size_case KEY_SIZES[] = {
+    { "AES-128", AES128_KEY, 16, AES128_PLAINTEXT, AES128_CIPHERTEXT, AES128_KEY, AES128_CBC_CIPHERTEXT,
+      AES128_CTR_CIPHERTEXT },
+    { "AES-192", AES192_KEY, 24, AES_FIPS_C_PLAINTEXT, AES192_CIPHERTEXT, AES192_CBC_KEY, AES192_CBC_CIPHERTEXT,
+      AES192_CTR_CIPHERTEXT },
+    { "AES-256", AES256_KEY, 32, AES_FIPS_C_PLAINTEXT, AES256_CIPHERTEXT, AES256_CBC_KEY, AES256_CBC_CIPHERTEXT,
+      AES256_CTR_CIPHERTEXT },
+};
+
+#define KEY_SIZE_COUNT (sizeof(KEY_SIZES) / sizeof(KEY_SIZES[0]))
+
+// 多路CBC加密：通道数以上、长度各异（含0）的任务，结果与逐条 aes_cbc_encrypt 一致，并支持原地加密
+// key_len 为 0 时各任务的密钥长度轮流取 16/24/32 字节（混合长度走逐块路径）
+#define MULTI_JOBS 11
+
+static int test_cbc_multi(const char *name, size_t key_len)
+{
+    aes_key_ctx ctx[MULTI_JOBS];
+    aes_cbc_job jobs[MULTI_JOBS];
+    byte data[MULTI_JOBS][20 * 16], out[MULTI_JOBS][20 * 16];
+    int failures = 0;
+
+    for (int i = 0; i < MULTI_JOBS; i++) {
+        byte key[32];
+        for (int j = 0; j < 32; j++) key[j] = (byte)(rand() & 0xff);
+        for (size_t j = 0; j < sizeof(data[i]); j++) data[i][j] = (byte)(rand() & 0xff);
+        aes_key_setup_engine(&ctx[i], key, key_len ? key_len : KEY_SIZES[i % KEY_SIZE_COUNT].key_len, name);
+        jobs[i].ctx = &ctx[i];
+        memcpy(jobs[i].iv, AES128_CBC_IV, 16);
+        jobs[i].input = data[i];
+        jobs[i].output = (i % 3 == 0) ? data[i] : out[i]; // 部分任务原地加密
+        jobs[i].length = (size_t)((i * 7) % 21) * 16;
+    }
+    // 原地任务会覆盖明文，先算出期望值
+    byte expected[MULTI_JOBS][20 * 16];
+    for (int i = 0; i < MULTI_JOBS; i++) {
+        aes_cbc_encrypt(&ctx[i], AES128_CBC_IV, data[i], expected[i], jobs[i].length);
+    }
+
+    aes_cbc_encrypt_multi(jobs, MULTI_JOBS);
+
+    for (int i = 0; i < MULTI_JOBS; i++) {
+        size_t len = jobs[i].length;
+        if (memcmp(jobs[i].output, expected[i], len) != 0) {
+            printf("FAIL: [%s] multi-stream CBC job %d (key_len %zu)\n", name, i, key_len);
+            failures++;
+        }
+        const byte *last = (len > 0) ? expected[i] + len - 16 : AES128_CBC_IV;
+        if (memcmp(jobs[i].iv, last, 16) != 0) {
+            printf("FAIL: [%s] multi-stream CBC chaining value %d (key_len %zu)\n", name, i, key_len);
+            failures++;
+        }
+        aes_key_clear(&ctx[i]);
+    }
+    return failures;
+}
+
+// CTR：标准向量（含原地）；对一段超过一批的数据，任意 (offset, length) 区间单独处理的结果与整段结果的对应部分一致；
+// 计数器低 64 位全为 1 时进位到高 64 位，与逐块参考实现一致
+#define CTR_LEN (40 * 16 + 9)
+
+static int test_ctr(const char *name, const struct key_size_case *ks)
+{
+    static byte data[CTR_LEN], full[CTR_LEN], part[CTR_LEN];
+    int failures = 0;
+    aes_key_ctx ctx, ref;
+    byte out[64];
+
+    // CTR 只用加密方向：被测上下文不生成解密轮密钥
+    aes_key_setup_encrypt_engine(&ctx, ks->cbc_key, ks->key_len, name);
+    aes_key_setup_engine(&ref, ks->cbc_key, ks->key_len, "ref");
+
+    aes_ctr_crypt(&ctx, AES_CTR_IV, 0, AES128_CBC_PLAINTEXT, out, sizeof(out));
+    if (memcmp(out, ks->ctr_ciphertext, sizeof(out)) != 0) {
+        printf("FAIL: [%s] %s CTR vector\n", name, ks->label);
+        failures++;
+    }
+    aes_ctr_crypt(&ctx, AES_CTR_IV, 0, out, out, sizeof(out));
+    if (memcmp(out, AES128_CBC_PLAINTEXT, sizeof(out)) != 0) {
+        printf("FAIL: [%s] %s in-place CTR decrypt\n", name, ks->label);
+        failures++;
+    }
+
+    for (size_t i = 0; i < CTR_LEN; i++) data[i] = (byte)(rand() & 0xff);
+    aes_ctr_crypt(&ctx, AES_CTR_IV, 0, data, full, CTR_LEN);
+    for (int t = 0; t < 200 && failures == 0; t++) {
+        size_t off = (size_t)rand() % CTR_LEN;
+        size_t len = (size_t)rand() % (CTR_LEN - off + 1);
+        aes_ctr_crypt(&ctx, AES_CTR_IV, off, data + off, part, len);
+        if (memcmp(part, full + off, len) != 0) {
+            printf("FAIL: [%s] %s CTR at offset %zu length %zu\n", name, ks->label, off, len);
+            failures++;
+        }
+    }
+
+    // 低 64 位为 0xff..fe：第 2 个分组处向高 64 位进位；分别从头处理（批内进位）与从进位之后的偏移处理（定位时进位）
+    byte iv[16], ctr[16], ks_block[16];
+    memset(iv, 0, 8);
+    memset(iv + 8, 0xff, 8);
+    iv[7] = 0x01;
+    iv[15] = 0xfe;
+    memcpy(ctr, iv, 16);
+    for (int b = 0; b < 6; b++) {
+        aes_encrypt_block(&ref, ctr, ks_block);
+        for (int j = 0; j < 16; j++) full[b * 16 + j] = data[b * 16 + j] ^ ks_block[j];
+        for (int j = 15; j >= 0 && ++ctr[j] == 0; j--) {}
+    }
+    aes_ctr_crypt(&ctx, iv, 0, data, part, 6 * 16);
+    if (memcmp(part, full, 6 * 16) != 0) {
+        printf("FAIL: [%s] %s CTR counter carry\n", name, ks->label);
+        failures++;
+    }
+    aes_ctr_crypt(&ctx, iv, 2 * 16 + 5, data + 2 * 16 + 5, part, 4 * 16 - 5);
+    if (memcmp(part, full + 2 * 16 + 5, 4 * 16 - 5) != 0) {
+        printf("FAIL: [%s] %s CTR counter carry at offset\n", name, ks->label);
+        failures++;
+    }
+
+    aes_key_clear(&ctx);
+    aes_key_clear(&ref);
+    return failures;
+}
+
+static int test_engine(const char *name, const struct key_size_case *ks)
+{
+    int failures = 0;
+    aes_key_ctx ctx, ref, cbc;
+    byte out[64], back[64];
+
+    if (aes_key_setup_engine(&ctx, ks->key, ks->key_len, name) != 0) {
+        printf("FAIL: [%s] engine not available\n", name);
+        return 1;
+    }
+    aes_key_setup_engine(&ref, ks->key, ks->key_len, "ref");
+    aes_key_setup_engine(&cbc, ks->cbc_key, ks->key_len, name);
+
+    // 每个引擎给出的等价逆密码轮密钥都必须相同（AES-NI 用 AESIMC，其余用 inv_key_expansion）
+    if (ctx.rounds != ref.rounds ||
+        memcmp(ctx.decKeys, ref.decKeys, (size_t)(ref.rounds + 1) * BLOCK_SIZE) != 0) {
+        printf("FAIL: [%s] %s decryption key schedule\n", name, ks->label);
+        failures++;
+    }
+
+    aes_encrypt_block(&ctx, ks->plaintext, out);
+    if (memcmp(out, ks->ciphertext, STATE_SIZE) != 0) {
+        printf("FAIL: [%s] %s FIPS-197 encrypt\n", name, ks->label);
+        failures++;
+    }
+    aes_decrypt_block(&ctx, ks->ciphertext, back);
+    if (memcmp(back, ks->plaintext, STATE_SIZE) != 0) {
+        printf("FAIL: [%s] %s FIPS-197 decrypt\n", name, ks->label);
+        failures++;
+    }
+
+    aes_cbc_encrypt(&cbc, AES128_CBC_IV, AES128_CBC_PLAINTEXT, out, sizeof(out));
+    if (memcmp(out, ks->cbc_ciphertext, sizeof(out)) != 0) {
+        printf("FAIL: [%s] %s CBC encrypt vector\n", name, ks->label);
+        failures++;
+    }
+    aes_cbc_decrypt(&cbc, AES128_CBC_IV, ks->cbc_ciphertext, back, sizeof(back));
+    if (memcmp(back, AES128_CBC_PLAINTEXT, sizeof(back)) != 0) {
+        printf("FAIL: [%s] %s CBC decrypt vector\n", name, ks->label);
+        failures++;
+    }
+
+    // 随机分组与参考实现交叉比对
+    srand(12345);
+    for (int i = 0; i < RANDOM_BLOCKS; i++) {
+        byte in[16], a[16], b[16];
+        for (int j = 0; j < 16; j++) in[j] = (byte)(rand() & 0xff);
+        aes_encrypt_block(&ctx, in, a);
+        aes_encrypt_block(&ref, in, b);
+        if (memcmp(a, b, 16) != 0) {
+            printf("FAIL: [%s] %s encrypt differs from ref at block %d\n", name, ks->label, i);
+            failures++;
+            break;
+        }
+        aes_decrypt_block(&ctx, in, a);
+        aes_decrypt_block(&ref, in, b);
+        if (memcmp(a, b, 16) != 0) {
+            printf("FAIL: [%s] %s decrypt differs from ref at block %d\n", name, ks->label, i);
+            failures++;
+            break;
+        }
+    }
+
+    // 多分组接口（数量不是批大小的整数倍）与逐块结果一致，CBC 原地解密正确
+    byte multi_in[19 * 16], multi_a[19 * 16], multi_b[19 * 16];
+    for (size_t j = 0; j < sizeof(multi_in); j++) multi_in[j] = (byte)(rand() & 0xff);
+    aes_encrypt_blocks(&ctx, multi_in, multi_a, 19);
+    for (int i = 0; i < 19; i++) aes_encrypt_block(&ref, multi_in + i * 16, multi_b + i * 16);
+    if (memcmp(multi_a, multi_b, sizeof(multi_a)) != 0) {
+        printf("FAIL: [%s] %s multi-block encrypt\n", name, ks->label);
+        failures++;
+    }
+    aes_decrypt_blocks(&ctx, multi_in, multi_a, 19);
+    for (int i = 0; i < 19; i++) aes_decrypt_block(&ref, multi_in + i * 16, multi_b + i * 16);
+    if (memcmp(multi_a, multi_b, sizeof(multi_a)) != 0) {
+        printf("FAIL: [%s] %s multi-block decrypt\n", name, ks->label);
+        failures++;
+    }
+    aes_cbc_encrypt(&ctx, AES128_CBC_IV, multi_in, multi_a, sizeof(multi_a));
+    aes_cbc_decrypt(&ctx, AES128_CBC_IV, multi_a, multi_a, sizeof(multi_a));
+    if (memcmp(multi_a, multi_in, sizeof(multi_a)) != 0) {
+        printf("FAIL: [%s] %s in-place CBC decrypt\n", name, ks->label);
+        failures++;
+    }
+
+    failures += test_cbc_multi(name, ks->key_len);
+    failures += test_ctr(name, ks);
+
+    aes_key_clear(&ctx);
+    aes_key_clear(&ref);
+    aes_key_clear(&cbc);
+    if (failures == 0) printf("PASS: [%s] %s engine\n", name, ks->label);
+    return failures;
+}
+
+int main(void)
+{
+    const char *names[16];
+    size_t count = aes_engine_list(names, 16);
+    int failures = 0;
+
+    aes_key_ctx def;
+    aes_key_init(&def, AES128_KEY);
+    printf("Default engine: %s\n", aes_engine_name(&def));
+    aes_key_clear(&def);
+
+    for (size_t i = 0; i < count; i++) {
+        for (size_t k = 0; k < KEY_SIZE_COUNT; k++) {
+            failures += test_engine(names[i], &KEY_SIZES[k]);
+        }
+        failures += test_cbc_multi(names[i], 0);
+    }
+
+    aes_key_ctx bad;
+    if (aes_key_setup(&bad, AES256_KEY, 20) != -1) {
+        printf("FAIL: invalid key length accepted\n");
+        failures++;
+    }
+
+    if (aes_engine_select("no-such-engine") != -1) {
+        printf("FAIL: unknown engine accepted\n");
+        failures++;
+    }
+
+    if (failures == 0)
+        printf("All AES engine tests passed\n");
+    else
+        printf("Some AES engine tests failed (failures=%d)\n", failures);
+    return failures != 0;
+}
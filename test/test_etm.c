@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <limits.h>
 #include "AES/AESEncryption.h"
 #include "AES/AESDecryption.h"
 
@@ -130,6 +131,64 @@ static int run_tamper_checks(const byte *ciperkey, const byte *mackey, const byt
     return failures;
 }
 
+// 批量接口：不同密钥、不同长度的任务交错加密，输出与逐个调用 encrypt_etm 完全相同
+#define BATCH_JOBS 13
+
+static int run_batch_check(const byte *mackey)
+{
+    int failures = 0;
+    aes_key_ctx ctx[BATCH_JOBS];
+    etm_job jobs[BATCH_JOBS];
+    byte keys[BATCH_JOBS][16], ivs[BATCH_JOBS][ETM_IV_SIZE];
+    byte msgs[BATCH_JOBS][200];
+    byte outs[BATCH_JOBS][200 + BLOCK_SIZE + ETM_OVERHEAD];
+    byte expect[200 + BLOCK_SIZE + ETM_OVERHEAD];
+
+    for (int i = 0; i < BATCH_JOBS; i++)
+    {
+        for (int j = 0; j < 16; j++) keys[i][j] = (byte)(i * 31 + j);
+        for (int j = 0; j < ETM_IV_SIZE; j++) ivs[i][j] = (byte)(i * 17 + j * 3);
+        for (int j = 0; j < 200; j++) msgs[i][j] = (byte)(i + j * 5);
+        aes_key_init(&ctx[i], keys[i]);
+        jobs[i].ctx = &ctx[i];
+        jobs[i].mac_key = mackey;
+        jobs[i].iv = ivs[i];
+        jobs[i].input = msgs[i];
+        jobs[i].input_len = (size_t)(i * 15) % 200; // 0字节到多个分组，链长各不相同
+        jobs[i].output = outs[i];
+    }
+
+    // 输出长度超过 INT_MAX 的任务直接失败，不写输出（只检查长度，不会读取 input）
+    etm_job big = jobs[1];
+    big.input_len = (size_t)INT_MAX;
+    memset(outs[1], 0xa5, sizeof(outs[1]));
+    if (encrypt_etm_batch(&big, 1) != 0 || big.output_len != -1 || outs[1][0] != 0xa5)
+    {
+        printf("FAIL: encrypt_etm_batch accepted an input longer than INT_MAX allows\n");
+        failures++;
+    }
+
+    if (encrypt_etm_batch(jobs, BATCH_JOBS) != BATCH_JOBS)
+    {
+        printf("FAIL: encrypt_etm_batch reported failures\n");
+        failures++;
+    }
+    for (int i = 0; i < BATCH_JOBS; i++)
+    {
+        int len = encrypt_etm(keys[i], (byte *)mackey, ivs[i], msgs[i], jobs[i].input_len, expect);
+        if (jobs[i].output_len != len || memcmp(outs[i], expect, len) != 0)
+        {
+            printf("FAIL: batch job %d differs from encrypt_etm\n", i);
+            failures++;
+        }
+        aes_key_clear(&ctx[i]);
+    }
+
+    if (failures == 0)
+        printf("Batch EtM encryption test passed\n");
+    return failures;
+}
+
 int main(void)
 {
     int failures = 0;
@@ -148,6 +207,8 @@ int main(void)
     const char *msg3 = "0123456789ABCDEF"; // block-aligned 16 bytes
     failures += run_roundtrip(ciph_key, mac_key, (const byte *)msg3, 16);
 
+    failures += run_batch_check(mac_key);
+
     // tamper checks
     failures += run_tamper_checks(ciph_key, mac_key, (const byte *)msg1, strlen(msg1));
 
@@ -252,6 +252,60 @@ void test_different_iterations()
     remove("test4_input.txt");
 }
 
+void test_key_sizes()
+{
+    printf("\n[Test 5] AES-128/192/256 File Keys\n");
+    fflush(stdout);
+
+    FILE *f = fopen("test5_input.txt", "wb");
+    fprintf(f, "Compliance profile requires AES-256 for data at rest");
+    fclose(f);
+
+    const char *password = "KeySizeTest";
+    size_t key_lens[] = {16, 24, 32};
+    int passed = 0;
+
+    for (int i = 0; i < 3; i++) {
+        int ret = encrypt_file_HKDF_keylen("test5_input.txt", "test5_encrypted.aes", password, strlen(password),
+                                           1000, key_lens[i]);
+        if (ret != 0) {
+            printf("    [-] AES-%zu encryption failed\n", key_lens[i] * 8);
+            continue;
+        }
+        // 文件头最高字节记录密钥长度，AES-128 保持旧格式的 0
+        byte header[4] = {0};
+        f = fopen("test5_encrypted.aes", "rb");
+        fread(header, 1, 4, f);
+        fclose(f);
+        byte expected = (key_lens[i] == 16) ? 0 : (byte)key_lens[i];
+
+        ret = decrypt_file_HKDF("test5_encrypted.aes", "test5_output.txt", password, strlen(password));
+        if (ret == 0 && header[0] == expected && compare_files("test5_input.txt", "test5_output.txt") == 0) {
+            printf("    [+] AES-%zu: OK\n", key_lens[i] * 8);
+            passed++;
+        } else {
+            printf("    [-] AES-%zu: FAILED\n", key_lens[i] * 8);
+        }
+        remove("test5_encrypted.aes");
+        remove("test5_output.txt");
+    }
+
+    if (encrypt_file_HKDF_keylen("test5_input.txt", "test5_encrypted.aes", password, strlen(password), 1000, 20) == 0) {
+        printf("    [-] Invalid key length accepted\n");
+        passed = 0;
+        remove("test5_encrypted.aes");
+    }
+
+    if (passed == 3) {
+        printf("TEST PASSED - All key sizes successful\n");
+    } else {
+        printf("TEST FAILED - Some key sizes failed\n");
+    }
+    fflush(stdout);
+
+    remove("test5_input.txt");
+}
+
 int main(void)
 {
     printf("========================================\n");
@@ -264,6 +318,7 @@ int main(void)
     test_wrong_password();
     test_binary_data();
     test_different_iterations();
+    test_key_sizes();
 
     printf("\n========================================\n");
     printf("All tests completed!\n");
@@ -1,7 +1,9 @@
 ﻿#include "crypto/gcm.h"
 #include <stdio.h>
+#include <limits.h>
 #include <stdlib.h>
 #include <string.h>
+#include "vectors.h"
 
 // NIST SP 800-38D Appendix B 测试向量
 // 参考：https://nvlpubs.nist.gov/nistpubs/Legacy/SP/nistspecialpublication800-38d.pdf
@@ -27,6 +29,352 @@ static int run_gcm_test(const char *name,
     return enc_ok && dec_ok;
 }
 
+static const char *const GHASH_IMPLS[] = { "table", "clmul" };
+
+// AES-192/256 经由密钥上下文，每种可用的 GHASH 实现各跑一遍
+static int run_gcm_ctx_test_impl(const char *name, const char *impl, const byte *key, size_t key_len,
+                            const byte *iv, size_t iv_len,
+                            const byte *aad, size_t aad_len,
+                            const byte *pt, size_t pt_len,
+                            const byte *expected_ct, const byte expected_tag[16])
+{
+    aes_gcm_ctx ctx;
+    byte ct[512];
+    byte tag[16];
+    byte recovered[512];
+
+    if (aes_gcm_key_init_ghash(&ctx, key, key_len, impl) != 0) {
+        printf("%s [%s]: not supported on this CPU, skipped\n", name, impl);
+        return 1;
+    }
+    aes_gcm_encrypt_ctx(&ctx, iv, iv_len, pt, pt_len, aad, aad_len, ct, tag);
+    int enc_ok = (memcmp(ct, expected_ct, pt_len) == 0) && (memcmp(tag, expected_tag, 16) == 0);
+
+    int dec_ret = aes_gcm_decrypt_ctx(&ctx, iv, iv_len, ct, pt_len, aad, aad_len, recovered, tag);
+    int dec_ok = (dec_ret == (int)pt_len) && (memcmp(recovered, pt, pt_len) == 0);
+    memset(recovered, 0, sizeof(recovered));
+    dec_ret = aes_gcm_verify_decrypt_ctx(&ctx, iv, iv_len, ct, pt_len, aad, aad_len, recovered, tag);
+    dec_ok &= (dec_ret == 0) && (memcmp(recovered, pt, pt_len) == 0);
+
+    // 篡改标签必须被拒绝；先认证后解密的模式完全不写输出
+    tag[0] ^= 1;
+    int rej_ok = aes_gcm_decrypt_ctx(&ctx, iv, iv_len, ct, pt_len, aad, aad_len, recovered, tag) < 0;
+    memset(recovered, 0xee, sizeof(recovered));
+    rej_ok &= aes_gcm_verify_decrypt_ctx(&ctx, iv, iv_len, ct, pt_len, aad, aad_len, recovered, tag) < 0;
+    for (size_t i = 0; i < pt_len; i++) rej_ok &= recovered[i] == 0xee;
+    aes_gcm_key_clear(&ctx);
+
+    printf("%s [%s]: encrypt=%s decrypt=%s reject=%s\n", name, impl, enc_ok ? "PASS" : "FAIL", dec_ok ? "PASS" : "FAIL",
+           rej_ok ? "PASS" : "FAIL");
+    return enc_ok && dec_ok && rej_ok;
+}
+
+static int run_gcm_ctx_test(const char *name, const byte *key, size_t key_len,
+                            const byte *iv, size_t iv_len,
+                            const byte *aad, size_t aad_len,
+                            const byte *pt, size_t pt_len,
+                            const byte *expected_ct, const byte expected_tag[16])
+{
+    int ok = 1;
+    for (size_t i = 0; i < sizeof(GHASH_IMPLS) / sizeof(GHASH_IMPLS[0]); i++)
+        ok &= run_gcm_ctx_test_impl(name, GHASH_IMPLS[i], key, key_len, iv, iv_len, aad, aad_len, pt, pt_len,
+                                    expected_ct, expected_tag);
+    return ok;
+}
+
+// 各 GHASH 实现必须与查表实现逐字节一致：覆盖 8 分组聚合与缝合核的批边界、不足一块的尾部和非 96 位 IV，
+// 并原地解密回原文（缝合核解密时边读密文边写明文）
+static int run_ghash_cross_check(void)
+{
+    enum { MAX_LEN = 8 * 16 * 8 + 17 };
+    static byte pt[MAX_LEN], aad[MAX_LEN], ct_ref[MAX_LEN], ct[MAX_LEN];
+    byte iv[60], tag_ref[16], tag[16];
+    aes_gcm_ctx ref, ctx;
+    int ok = 1;
+
+    for (size_t i = 0; i < MAX_LEN; i++) {
+        pt[i] = (byte)(i * 13 + 1);
+        aad[i] = (byte)(i * 7 + 3);
+    }
+    for (size_t i = 0; i < sizeof(iv); i++) iv[i] = (byte)(0xa0 + i);
+
+    aes_gcm_key_init_ghash(&ref, GCM_TC16_KEY, sizeof(GCM_TC16_KEY), "table");
+    for (size_t k = 1; k < sizeof(GHASH_IMPLS) / sizeof(GHASH_IMPLS[0]); k++) {
+        if (aes_gcm_key_init_ghash(&ctx, GCM_TC16_KEY, sizeof(GCM_TC16_KEY), GHASH_IMPLS[k]) != 0)
+            continue;
+        int impl_ok = 1;
+        for (size_t len = 0; len <= MAX_LEN; len += (len < 300 ? 1 : 37)) {
+            size_t aad_len = (len * 5) % MAX_LEN;
+            size_t iv_len = (len % 3 == 0) ? 12 : 1 + len % sizeof(iv);
+            aes_gcm_encrypt_ctx(&ref, iv, iv_len, pt, len, aad, aad_len, ct_ref, tag_ref);
+            aes_gcm_encrypt_ctx(&ctx, iv, iv_len, pt, len, aad, aad_len, ct, tag);
+            if (memcmp(ct, ct_ref, len) != 0 || memcmp(tag, tag_ref, 16) != 0) {
+                printf("GHASH %s mismatch: len=%zu aad_len=%zu iv_len=%zu\n", GHASH_IMPLS[k], len, aad_len, iv_len);
+                impl_ok = 0;
+                break;
+            }
+            if (aes_gcm_decrypt_ctx(&ctx, iv, iv_len, ct, len, aad, aad_len, ct, tag) != (int)len ||
+                memcmp(ct, pt, len) != 0) {
+                printf("GHASH %s in-place decrypt failed: len=%zu\n", GHASH_IMPLS[k], len);
+                impl_ok = 0;
+                break;
+            }
+        }
+        aes_gcm_key_clear(&ctx);
+        printf("GHASH %s vs table: %s\n", GHASH_IMPLS[k], impl_ok ? "PASS" : "FAIL");
+        ok &= impl_ok;
+    }
+    aes_gcm_key_clear(&ref);
+    return ok;
+}
+
+// 流式接口按各种片段长度切分 AAD 与数据，结果必须与一次性接口逐字节相同
+static void stream_feed(aes_gcm_stream *st, const byte *aad, size_t aad_len, const byte *in, byte *out, size_t len,
+                        size_t pattern)
+{
+    static const size_t pieces[] = { 1, 5, 16, 17, 31, 64, 127, 128, 129, 300 };
+    size_t n = sizeof(pieces) / sizeof(pieces[0]);
+    for (size_t off = 0, i = pattern; off < aad_len; i++) {
+        size_t step = pieces[i % n] < aad_len - off ? pieces[i % n] : aad_len - off;
+        aes_gcm_stream_aad(st, aad + off, step);
+        off += step;
+    }
+    for (size_t off = 0, i = pattern; off < len; i += 3) {
+        size_t step = pieces[i % n] < len - off ? pieces[i % n] : len - off;
+        aes_gcm_stream_update(st, in + off, out + off, step);
+        off += step;
+    }
+}
+
+static int run_stream_test(const char *impl)
+{
+    enum { LEN = 2000, AAD_LEN = 100 };
+    static byte pt[LEN], aad[AAD_LEN], ct_ref[LEN], ct[LEN];
+    byte tag_ref[16], tag[16];
+    aes_gcm_ctx ctx;
+    aes_gcm_stream st;
+    int ok = 1;
+
+    if (aes_gcm_key_init_ghash(&ctx, GCM_TC16_KEY, sizeof(GCM_TC16_KEY), impl) != 0)
+        return 1;
+    for (size_t i = 0; i < LEN; i++) pt[i] = (byte)(i * 29 + 5);
+    for (size_t i = 0; i < AAD_LEN; i++) aad[i] = (byte)(i ^ 0x5a);
+    aes_gcm_encrypt_ctx(&ctx, GCM_TC4_IV, sizeof(GCM_TC4_IV), pt, LEN, aad, AAD_LEN, ct_ref, tag_ref);
+
+    for (size_t pattern = 0; pattern < 10 && ok; pattern++) {
+        aes_gcm_stream_init(&st, &ctx, GCM_TC4_IV, sizeof(GCM_TC4_IV), 1);
+        stream_feed(&st, aad, AAD_LEN, pt, ct, LEN, pattern);
+        aes_gcm_stream_final(&st, tag);
+        if (memcmp(ct, ct_ref, LEN) != 0 || memcmp(tag, tag_ref, 16) != 0) {
+            printf("stream encrypt mismatch [%s] pattern %zu\n", impl, pattern);
+            ok = 0;
+        }
+        // 原地流式解密
+        aes_gcm_stream_init(&st, &ctx, GCM_TC4_IV, sizeof(GCM_TC4_IV), 0);
+        stream_feed(&st, aad, AAD_LEN, ct, ct, LEN, pattern + 1);
+        if (aes_gcm_stream_verify(&st, tag_ref) != 0 || memcmp(ct, pt, LEN) != 0) {
+            printf("stream decrypt failed [%s] pattern %zu\n", impl, pattern);
+            ok = 0;
+        }
+    }
+
+    // NIST Case 4 逐字节送入
+    aes_gcm_key_init_ghash(&ctx, GCM_TC4_KEY, sizeof(GCM_TC4_KEY), impl);
+    aes_gcm_stream_init(&st, &ctx, GCM_TC4_IV, sizeof(GCM_TC4_IV), 1);
+    for (size_t i = 0; i < sizeof(GCM_TC4_AAD); i++) aes_gcm_stream_aad(&st, GCM_TC4_AAD + i, 1);
+    for (size_t i = 0; i < sizeof(GCM_TC4_PLAINTEXT); i++) aes_gcm_stream_update(&st, GCM_TC4_PLAINTEXT + i, ct + i, 1);
+    aes_gcm_stream_final(&st, tag);
+    if (memcmp(ct, GCM_TC4_CIPHERTEXT, sizeof(GCM_TC4_CIPHERTEXT)) != 0 || memcmp(tag, GCM_TC4_TAG, 16) != 0) {
+        printf("stream byte-by-byte NIST Case 4 failed [%s]\n", impl);
+        ok = 0;
+    }
+
+    // 篡改的标签、数据之后再送 AAD、结束后继续调用都必须失败
+    tag[0] ^= 1;
+    aes_gcm_stream_init(&st, &ctx, GCM_TC4_IV, sizeof(GCM_TC4_IV), 0);
+    aes_gcm_stream_aad(&st, GCM_TC4_AAD, sizeof(GCM_TC4_AAD));
+    aes_gcm_stream_update(&st, GCM_TC4_CIPHERTEXT, ct, sizeof(GCM_TC4_CIPHERTEXT));
+    if (aes_gcm_stream_verify(&st, tag) == 0) ok = 0;
+    if (aes_gcm_stream_update(&st, pt, ct, 16) == 0) ok = 0;
+    aes_gcm_stream_init(&st, &ctx, GCM_TC4_IV, sizeof(GCM_TC4_IV), 1);
+    aes_gcm_stream_update(&st, pt, ct, 16);
+    if (aes_gcm_stream_aad(&st, aad, 16) == 0) ok = 0;
+    aes_gcm_stream_final(&st, tag);
+
+    aes_gcm_key_clear(&ctx);
+    printf("GCM streaming API [%s]: %s\n", impl, ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+// 批量接口：长度（含超过一组容量的长消息）、IV 长度、AAD 各不相同，逐条结果必须与单条接口一致；
+// 批量原地解密，其中一条被篡改时只有它失败且输出未被写入
+static int run_batch_test(const char *impl)
+{
+    enum { JOBS = 40, MAX_LEN = 2100 };
+    static byte pt[MAX_LEN], aad[64], ct[JOBS][MAX_LEN], ref[MAX_LEN];
+    byte ivs[JOBS][60], tags[JOBS][16], ref_tag[16];
+    aes_gcm_job jobs[JOBS];
+    aes_gcm_ctx ctx;
+    int ok = 1;
+
+    if (aes_gcm_key_init_ghash(&ctx, GCM_TC16_KEY, sizeof(GCM_TC16_KEY), impl) != 0)
+        return 1;
+    for (size_t i = 0; i < MAX_LEN; i++) pt[i] = (byte)(i * 3 + 1);
+    for (size_t i = 0; i < sizeof(aad); i++) aad[i] = (byte)(0x30 + i);
+
+    for (size_t j = 0; j < JOBS; j++) {
+        for (size_t i = 0; i < sizeof(ivs[j]); i++) ivs[j][i] = (byte)(j * 17 + i);
+        jobs[j].iv = ivs[j];
+        jobs[j].iv_len = (j % 7 == 3) ? 60 : GCM_IV_SIZE;
+        jobs[j].aad = aad;
+        jobs[j].aad_len = (j * 13) % sizeof(aad);
+        jobs[j].input = pt;
+        jobs[j].output = ct[j];
+        jobs[j].length = (j % 10 == 9) ? MAX_LEN - j : (j * j * 7) % 300;
+        jobs[j].tag = tags[j];
+    }
+    if (aes_gcm_encrypt_batch(&ctx, jobs, JOBS) != 0) ok = 0;
+    for (size_t j = 0; j < JOBS && ok; j++) {
+        aes_gcm_encrypt_ctx(&ctx, jobs[j].iv, jobs[j].iv_len, pt, jobs[j].length, aad, jobs[j].aad_len, ref, ref_tag);
+        if (jobs[j].result != 0 || memcmp(ct[j], ref, jobs[j].length) != 0 || memcmp(tags[j], ref_tag, 16) != 0) {
+            printf("batch encrypt mismatch [%s] job %zu (len %zu)\n", impl, j, jobs[j].length);
+            ok = 0;
+        }
+    }
+
+    for (size_t j = 0; j < JOBS; j++) {
+        jobs[j].input = ct[j];
+        jobs[j].output = ct[j];
+    }
+    tags[5][3] ^= 1;
+    memcpy(ref, ct[5], jobs[5].length);
+    size_t failures = aes_gcm_decrypt_batch(&ctx, jobs, JOBS);
+    if (failures != 1 || jobs[5].result != -1 || memcmp(ct[5], ref, jobs[5].length) != 0) ok = 0;
+    for (size_t j = 0; j < JOBS; j++) {
+        if (j != 5 && (jobs[j].result != 0 || memcmp(ct[j], pt, jobs[j].length) != 0)) {
+            printf("batch decrypt failed [%s] job %zu\n", impl, j);
+            ok = 0;
+        }
+    }
+
+    aes_gcm_key_clear(&ctx);
+    printf("GCM batch API [%s]: %s\n", impl, ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+// GMAC：IEEE 802.1AE 54 字节报文仅认证的向量（GCM-AES-128），一次性与流式结果一致，
+// 长消息与明文为空的 GCM 标签一致，篡改的数据或标签被拒绝
+static int run_gmac_test(const char *impl)
+{
+    static const byte key[16] = {
+        0xad,0x7a,0x2b,0xd0,0x3e,0xac,0x83,0x5a,0x6f,0x62,0x0f,0xdc,0xb5,0x06,0xb3,0x45
+    };
+    static const byte iv[12] = {
+        0x12,0x15,0x35,0x24,0xc0,0x89,0x5e,0x81,0xb2,0xc2,0x84,0x65
+    };
+    static const byte data[70] = {
+        0xd6,0x09,0xb1,0xf0,0x56,0x63,0x7a,0x0d,0x46,0xdf,0x99,0x8d,0x88,0xe5,0x22,0x2a,
+        0xb2,0xc2,0x84,0x65,0x12,0x15,0x35,0x24,0xc0,0x89,0x5e,0x81,0x08,0x00,0x0f,0x10,
+        0x11,0x12,0x13,0x14,0x15,0x16,0x17,0x18,0x19,0x1a,0x1b,0x1c,0x1d,0x1e,0x1f,0x20,
+        0x21,0x22,0x23,0x24,0x25,0x26,0x27,0x28,0x29,0x2a,0x2b,0x2c,0x2d,0x2e,0x2f,0x30,
+        0x31,0x32,0x33,0x34,0x00,0x01
+    };
+    static const byte expected_tag[16] = {
+        0xf0,0x94,0x78,0xa9,0xb0,0x90,0x07,0xd0,0x6f,0x46,0xe9,0xb6,0xa1,0xda,0x25,0xdd
+    };
+    enum { LONG_LEN = 3000 };
+    static byte msg[LONG_LEN];
+    byte tag[16], ref_tag[16];
+    aes_gcm_ctx ctx;
+    aes_gmac_stream st;
+    int ok = 1;
+
+    if (aes_gcm_key_init_ghash(&ctx, key, sizeof(key), impl) != 0)
+        return 1;
+    if (aes_gmac_ctx(&ctx, iv, sizeof(iv), data, sizeof(data), tag) != 0 || memcmp(tag, expected_tag, 16) != 0 ||
+        aes_gmac_verify_ctx(&ctx, iv, sizeof(iv), data, sizeof(data), expected_tag) != 0)
+        ok = 0;
+
+    for (size_t i = 0; i < LONG_LEN; i++) msg[i] = (byte)(i * 7 + 5);
+    aes_gcm_encrypt_ctx(&ctx, iv, sizeof(iv), NULL, 0, msg, LONG_LEN, NULL, ref_tag);
+    aes_gmac_ctx(&ctx, iv, sizeof(iv), msg, LONG_LEN, tag);
+    if (memcmp(tag, ref_tag, 16) != 0) ok = 0;
+
+    // 流式：长度 0..37 循环的片段
+    aes_gmac_stream_init(&st, &ctx, iv, sizeof(iv));
+    for (size_t off = 0, step = 0; off < LONG_LEN; step = (step + 1) % 38) {
+        size_t n = (step < LONG_LEN - off) ? step : LONG_LEN - off;
+        aes_gmac_stream_update(&st, msg + off, n);
+        off += n;
+    }
+    if (aes_gmac_stream_final(&st, tag) != 0 || memcmp(tag, ref_tag, 16) != 0) ok = 0;
+    if (aes_gmac_stream_update(&st, msg, 1) != -1) ok = 0; // 结束后不能再送数据
+    aes_gmac_stream_init(&st, &ctx, iv, sizeof(iv));
+    aes_gmac_stream_update(&st, msg, LONG_LEN);
+    if (aes_gmac_stream_verify(&st, ref_tag) != 0) ok = 0;
+
+    msg[LONG_LEN / 2] ^= 1;
+    if (aes_gmac_verify_ctx(&ctx, iv, sizeof(iv), msg, LONG_LEN, ref_tag) != -1) ok = 0;
+    msg[LONG_LEN / 2] ^= 1;
+    ref_tag[15] ^= 0x80;
+    if (aes_gmac_verify_ctx(&ctx, iv, sizeof(iv), msg, LONG_LEN, ref_tag) != -1) ok = 0;
+    if (aes_gmac_ctx(&ctx, iv, 0, msg, LONG_LEN, tag) != -1) ok = 0;
+
+    aes_gcm_key_clear(&ctx);
+    printf("GMAC [%s]: %s\n", impl, ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+// 超过 INT_MAX 字节的消息：返回明文长度的 aes_gcm_decrypt_ctx 无法表示，解密前即返回 -1 且不写输出；
+// 新接口（parallel、verify）成功返回 0，不会因 (int)ct_len 在 2-4 GiB 得到负数或恰好为 -1。
+// 需要约 2 GiB 内存与 AES-NI + CLMUL（否则太慢），不满足时跳过
+#define GCM_HUGE_LEN ((size_t)INT_MAX + 17)
+
+static int run_huge_test(void)
+{
+    static const byte key[16] = {0x42}, iv[12] = {0x24};
+    byte tag[16], tag2[16];
+    aes_gcm_ctx ctx;
+    byte *buf;
+    int ok = 1;
+
+    if (SIZE_MAX <= (size_t)INT_MAX + 17 || aes_gcm_key_init(&ctx, key, sizeof(key)) != 0)
+        return 1;
+    if (strcmp(aes_engine_name(&ctx.key), "aesni") != 0 || strcmp(aes_gcm_ghash_name(&ctx), "clmul") != 0 ||
+        (buf = (byte *)calloc(GCM_HUGE_LEN, 1)) == NULL) {
+        printf("GCM > INT_MAX bytes: not supported on this machine, skipped\n");
+        aes_gcm_key_clear(&ctx);
+        return 1;
+    }
+
+    aes_gcm_encrypt_ctx(&ctx, iv, sizeof(iv), buf, GCM_HUGE_LEN, NULL, 0, buf, tag);
+    byte first = buf[0], last = buf[GCM_HUGE_LEN - 1];
+    if (aes_gcm_decrypt_ctx(&ctx, iv, sizeof(iv), buf, GCM_HUGE_LEN, NULL, 0, buf, tag) != -1 ||
+        buf[0] != first || buf[GCM_HUGE_LEN - 1] != last)
+        ok = 0;
+    if (aes_gcm_decrypt_parallel(&ctx, iv, sizeof(iv), buf, GCM_HUGE_LEN, NULL, 0, buf, tag, 2) != 0 ||
+        buf[0] != 0 || buf[GCM_HUGE_LEN - 1] != 0)
+        ok = 0;
+    aes_gcm_encrypt_parallel(&ctx, iv, sizeof(iv), buf, GCM_HUGE_LEN, NULL, 0, buf, tag2, 2);
+    if (memcmp(tag, tag2, 16) != 0 ||
+        aes_gcm_decrypt_parallel(&ctx, iv, sizeof(iv), buf, GCM_HUGE_LEN, NULL, 0, buf, tag, 2) != 0)
+        ok = 0;
+    aes_gcm_encrypt_ctx(&ctx, iv, sizeof(iv), buf, GCM_HUGE_LEN, NULL, 0, buf, tag);
+    if (aes_gcm_verify_decrypt_ctx(&ctx, iv, sizeof(iv), buf, GCM_HUGE_LEN, NULL, 0, buf, tag) != 0 ||
+        buf[0] != 0 || buf[GCM_HUGE_LEN - 1] != 0)
+        ok = 0;
+    aes_gcm_encrypt_ctx(&ctx, iv, sizeof(iv), buf, GCM_HUGE_LEN, NULL, 0, buf, tag);
+    tag[0] ^= 1;
+    if (aes_gcm_decrypt_parallel(&ctx, iv, sizeof(iv), buf, GCM_HUGE_LEN, NULL, 0, buf, tag, 2) != -1 ||
+        aes_gcm_verify_decrypt_ctx(&ctx, iv, sizeof(iv), buf, GCM_HUGE_LEN, NULL, 0, buf, tag) != -1)
+        ok = 0;
+
+    free(buf);
+    aes_gcm_key_clear(&ctx);
+    printf("GCM > INT_MAX bytes: %s\n", ok ? "PASS" : "FAIL");
+    return ok;
+}
+
 int main() {
     // Case 1: empty plaintext + empty AAD
     static const byte key1[16] = {0x00};
@@ -62,6 +410,20 @@ int main() {
     ok &= run_gcm_test("NIST Case 1", key1, iv1, 12, NULL, 0, NULL, 0, NULL, expected_tag1);
     ok &= run_gcm_test("NIST Case 2", key2, iv2, 12, NULL, 0, pt2, 16, expected_ct2, expected_tag2);
     ok &= run_gcm_test("NIST Case 3", key3, iv3, 12, aad3, 16, NULL, 0, NULL, expected_tag3);
+    ok &= run_gcm_ctx_test("NIST Case 16 (AES-256)", GCM_TC16_KEY, sizeof(GCM_TC16_KEY), GCM_TC4_IV, sizeof(GCM_TC4_IV),
+                           GCM_TC4_AAD, sizeof(GCM_TC4_AAD), GCM_TC4_PLAINTEXT, sizeof(GCM_TC4_PLAINTEXT),
+                           GCM_TC16_CIPHERTEXT, GCM_TC16_TAG);
+    ok &= run_gcm_ctx_test("NIST Case 4", GCM_TC4_KEY, sizeof(GCM_TC4_KEY), GCM_TC4_IV, sizeof(GCM_TC4_IV),
+                           GCM_TC4_AAD, sizeof(GCM_TC4_AAD), GCM_TC4_PLAINTEXT, sizeof(GCM_TC4_PLAINTEXT),
+                           GCM_TC4_CIPHERTEXT, GCM_TC4_TAG);
+    ok &= run_ghash_cross_check();
+    for (size_t i = 0; i < sizeof(GHASH_IMPLS) / sizeof(GHASH_IMPLS[0]); i++)
+        ok &= run_stream_test(GHASH_IMPLS[i]);
+    for (size_t i = 0; i < sizeof(GHASH_IMPLS) / sizeof(GHASH_IMPLS[0]); i++)
+        ok &= run_batch_test(GHASH_IMPLS[i]);
+    for (size_t i = 0; i < sizeof(GHASH_IMPLS) / sizeof(GHASH_IMPLS[0]); i++)
+        ok &= run_gmac_test(GHASH_IMPLS[i]);
+    ok &= run_huge_test();
 
     if (!ok) {
         printf("至少一个测试用例失败。\n");
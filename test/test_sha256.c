@@ -24,7 +24,60 @@ static int test_vector(const byte *msg, size_t msg_len, const char *expected_hex
     }
 }
 
-int main() {
+// 增量接口：消息在每个位置切成两段输入，结果都必须与整条消息的期望值一致
+static int test_split(const byte *msg, size_t msg_len, const char *expected_hex) {
+    byte digest[SHA256_HASH_SIZE];
+    char hex[SHA256_HASH_SIZE * 2 + 1];
+    for (size_t cut = 0; cut <= msg_len; cut++) {
+        sha256_ctx ctx;
+        sha256_init(&ctx);
+        sha256_update(&ctx, msg, cut);
+        sha256_update(&ctx, msg + cut, msg_len - cut);
+        sha256_final(&ctx, digest);
+        to_hex(digest, hex);
+        if (strcmp(hex, expected_hex) != 0) {
+            printf("FAIL: (%zu bytes) split at %zu\n", msg_len, cut);
+            return 1;
+        }
+    }
+    printf("PASS: (%zu bytes) every split point\n", msg_len);
+    return 0;
+}
+
+// 一百万个 'a'（FIPS 180-2 附录 B.3），按不规则的分段长度输入，覆盖缓冲区跨分组补满的各种情况
+static int test_million_a(void) {
+    const size_t total = 1000000;
+    byte *msg = (byte *)malloc(total);
+    byte digest[SHA256_HASH_SIZE];
+    char hex[SHA256_HASH_SIZE * 2 + 1];
+    const char *expected = "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0";
+    int failures = 0;
+    if (msg == NULL) {
+        printf("Memory allocation failed\n");
+        return 1;
+    }
+    memset(msg, 'a', total);
+
+    sha256(msg, total, digest);
+    to_hex(digest, hex);
+    failures += strcmp(hex, expected) != 0;
+
+    sha256_ctx ctx;
+    sha256_init(&ctx);
+    for (size_t off = 0, step = 1; off < total; off += step, step = step * 7 % 193 + 1) {
+        size_t n = (total - off < step) ? total - off : step;
+        sha256_update(&ctx, msg + off, n);
+    }
+    sha256_final(&ctx, digest);
+    to_hex(digest, hex);
+    failures += strcmp(hex, expected) != 0;
+
+    free(msg);
+    printf("%s: one million 'a' (one-shot and streamed)\n", failures ? "FAIL" : "PASS");
+    return failures != 0;
+}
+
+static int run_vectors(void) {
     int failures = 0;
 
     failures += test_vector((const byte*)"", 0, "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
@@ -33,6 +86,125 @@ int main() {
                              strlen("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"),
                              "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
 
+    failures += test_vector((const byte*)"abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu",
+                             112, "cf5b16a778af8380036ce59e7b0492370b249b11e8f07a51afac45037afee9d1");
+
+    // 填充边界：55 字节时长度字段恰好放进同一分组，56~63 字节需要多一个分组
+    static const struct { size_t len; const char *hex; } boundary[] = {
+        { 55, "9f4390f8d30c2dd92ec9f095b65e2b9ae9b0a925a5258e241c9f1e910f734318" },
+        { 56, "b35439a4ac6f0948b6d6f9e3c6af0f5f590ce20f1bde7090ef7970686ec6738a" },
+        { 63, "7d3e74a05d7db15bce4ad9ec0658ea98e3f06eeecf16b4c6fff2da457ddc2f34" },
+        { 64, "ffe054fe7ae0cb6dc65c3af9b61d5209f439851db43d0ba5997337df154668eb" },
+        { 65, "635361c48bb9eab14198e76ea8ab7f1a41685d6ad62aa9146d301d4f17eb0ae0" },
+        { 119, "31eba51c313a5c08226adf18d4a359cfdfd8d2e816b13f4af952f7ea6584dcfb" },
+        { 120, "2f3d335432c70b580af0e8e1b3674a7c020d683aa5f73aaaedfdc55af904c21c" },
+    };
+    byte a_msg[128];
+    memset(a_msg, 'a', sizeof(a_msg));
+    for (size_t i = 0; i < sizeof(boundary) / sizeof(boundary[0]); i++) {
+        failures += test_vector(a_msg, boundary[i].len, boundary[i].hex);
+        failures += test_split(a_msg, boundary[i].len, boundary[i].hex);
+    }
+    failures += test_split((const byte*)"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", 56,
+                           "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+    failures += test_million_a();
+    return failures;
+}
+
+// 与可移植实现逐字节比对：各种长度（跨越多分组一次压缩的情况）与不同的分段方式
+static int test_against_scalar(const char *impl) {
+    enum { MAX_LEN = 64 * 40 + 3 };
+    static byte msg[MAX_LEN];
+    byte ref[SHA256_HASH_SIZE], digest[SHA256_HASH_SIZE];
+    int failures = 0;
+
+    for (size_t i = 0; i < MAX_LEN; i++) msg[i] = (byte)(i * 31 + (i >> 7));
+    for (size_t len = 0; len <= MAX_LEN && failures == 0; len += (len < 200) ? 1 : 61) {
+        sha256_select_impl("scalar");
+        sha256(msg, len, ref);
+        sha256_select_impl(impl);
+        sha256(msg, len, digest);
+        if (memcmp(ref, digest, SHA256_HASH_SIZE) != 0) {
+            printf("FAIL: [%s] differs from scalar at %zu bytes\n", impl, len);
+            failures++;
+        }
+        sha256_ctx ctx;
+        sha256_init(&ctx);
+        sha256_update(&ctx, msg, len / 3);
+        sha256_update(&ctx, msg + len / 3, len - len / 3);
+        sha256_final(&ctx, digest);
+        if (memcmp(ref, digest, SHA256_HASH_SIZE) != 0) {
+            printf("FAIL: [%s] streamed differs from scalar at %zu bytes\n", impl, len);
+            failures++;
+        }
+    }
+    if (failures == 0) printf("PASS: [%s] matches scalar on 0..%d bytes\n", impl, MAX_LEN);
+    return failures;
+}
+
+// 多通道：长度各异的消息（含空消息、填充边界与跨多个分组的长消息）混在一起，每条结果与 sha256 相同；
+// 不同的消息条数覆盖通道未填满、中途补位与单流收尾
+static int test_multi(const char *impl) {
+    enum { NJOBS = 45, MAX_LEN = 64 * 33 };
+    static byte msg[MAX_LEN];
+    static byte digests[NJOBS][SHA256_HASH_SIZE];
+    sha256_job jobs[NJOBS];
+    byte ref[SHA256_HASH_SIZE];
+    int failures = 0;
+
+    for (size_t i = 0; i < MAX_LEN; i++) msg[i] = (byte)(i * 13 + (i >> 8));
+    for (size_t n = 1; n <= NJOBS && failures == 0; n += (n < 10) ? 1 : 7) {
+        for (size_t j = 0; j < n; j++) {
+            jobs[j].len = (j % 5 == 4) ? MAX_LEN - j * 17 : (j * 29 + n) % 130;
+            jobs[j].data = msg + (j * 3) % 64;
+            if (jobs[j].data + jobs[j].len > msg + MAX_LEN) jobs[j].data = msg;
+            jobs[j].digest = digests[j];
+        }
+        sha256_multi(jobs, n);
+        for (size_t j = 0; j < n; j++) {
+            sha256(jobs[j].data, jobs[j].len, ref);
+            if (memcmp(ref, digests[j], SHA256_HASH_SIZE) != 0) {
+                printf("FAIL: multi [%s] %zu jobs, job %zu (%zu bytes)\n", impl, n, j, jobs[j].len);
+                failures++;
+                break;
+            }
+        }
+    }
+    sha256_multi(jobs, 0);
+    if (failures == 0) printf("PASS: multi-buffer [%s]\n", impl);
+    return failures;
+}
+
+// 每种当前 CPU 可用的压缩实现各跑一遍全部向量
+int main() {
+    static const char *const impls[] = { "scalar", "ssse3", "avx2", "shani" };
+    int failures = 0;
+
+    for (size_t i = 0; i < sizeof(impls) / sizeof(impls[0]); i++) {
+        if (sha256_select_impl(impls[i]) != 0) {
+            printf("SKIP: [%s] not supported on this CPU\n", impls[i]);
+            continue;
+        }
+        printf("[%s]\n", impls[i]);
+        failures += run_vectors();
+        if (i > 0) failures += test_against_scalar(impls[i]);
+    }
+
+
+    // 多通道实现分别配合 scalar 与自动选择的单流实现（有 SHA 扩展时长消息不进通道，收尾也走 shani）
+    static const char *const single_impls[] = { "scalar", NULL };
+    static const char *const multi_impls[] = { "single", "sse4", "avx2" };
+    for (size_t k = 0; k < sizeof(single_impls) / sizeof(single_impls[0]); k++) {
+        sha256_select_impl(single_impls[k]);
+        printf("[multi-buffer, single-stream %s]\n", sha256_impl_name());
+        for (size_t i = 0; i < sizeof(multi_impls) / sizeof(multi_impls[0]); i++) {
+            if (sha256_multi_select_impl(multi_impls[i]) != 0) {
+                printf("SKIP: multi-buffer [%s] not supported on this CPU\n", multi_impls[i]);
+                continue;
+            }
+            failures += test_multi(multi_impls[i]);
+        }
+    }
 
     if (failures == 0) {
         printf("All tests passed\n");
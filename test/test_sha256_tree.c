@@ -0,0 +1,145 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "crypto/sha256_tree.h"
+
+// SHA-256 Merkle 树：与按 RFC 6962 递归定义直接算出的根比对（叶子数 1-40、末尾叶子长短不一），
+// 线程数不影响结果，按窗口建树与一次建树一致，修改一段数据后只更新该叶子的结果与重建一致，非法参数被拒绝；
+// 每种可用的压缩实现各跑一遍
+
+#define TREE_MAX_LEN (40 * 96)
+
+static const char *const SHA256_IMPLS[] = { "scalar", "ssse3", "avx2", "shani" };
+
+// RFC 6962 2.1：MTH(D[n]) = SHA-256(0x01 || MTH(D[0:k]) || MTH(D[k:n]))，k 为小于 n 的最大 2 的幂
+static void reference_root(byte *const leaves[], const size_t lens[], size_t n, byte out[SHA256_HASH_SIZE])
+{
+    byte buf[1 + 2 * SHA256_HASH_SIZE];
+    if (n == 1) {
+        byte tmp[1 + 96];
+        tmp[0] = 0x00;
+        memcpy(tmp + 1, leaves[0], lens[0]);
+        sha256(tmp, 1 + lens[0], out);
+        return;
+    }
+    size_t k = 1;
+    while (2 * k < n) k *= 2;
+    buf[0] = 0x01;
+    reference_root(leaves, lens, k, buf + 1);
+    reference_root(leaves + k, lens + k, n - k, buf + 1 + SHA256_HASH_SIZE);
+    sha256(buf, sizeof(buf), out);
+}
+
+static void reference_digest(const byte *data, size_t len, size_t leaf_size, byte out[SHA256_HASH_SIZE])
+{
+    byte *leaves[TREE_MAX_LEN + 1];
+    size_t lens[TREE_MAX_LEN + 1], n = 0;
+    do {
+        leaves[n] = (byte *)data + n * leaf_size;
+        lens[n] = len - n * leaf_size < leaf_size ? len - n * leaf_size : leaf_size;
+        n++;
+    } while (n * leaf_size < len);
+    reference_root(leaves, lens, n, out);
+}
+
+static int test_reference(byte *data)
+{
+    static const size_t leaf_sizes[] = { 1, 64, 96 };
+    byte root[SHA256_HASH_SIZE], expected[SHA256_HASH_SIZE];
+    int ok = 1;
+
+    for (size_t s = 0; s < sizeof(leaf_sizes) / sizeof(leaf_sizes[0]); s++) {
+        size_t leaf = leaf_sizes[s];
+        for (size_t len = 0; len <= 40 * leaf; len += (leaf == 1) ? 1 : 31) {
+            reference_digest(data, len, leaf, expected);
+            for (int threads = 1; threads <= 5; threads += 2) {
+                if (sha256_tree_digest(data, len, leaf, threads, root) != 0 || memcmp(root, expected, 32) != 0) {
+                    printf("Tree mismatch leaf %zu len %zu threads %d\n", leaf, len, threads);
+                    ok = 0;
+                }
+            }
+        }
+    }
+
+    // 空数据的根为 SHA-256(0x00)，与单个空叶子相同
+    byte zero = 0x00;
+    sha256(&zero, 1, expected);
+    if (sha256_tree_digest(NULL, 0, 0, 0, root) != 0 || memcmp(root, expected, 32) != 0) ok = 0;
+    return ok;
+}
+
+// 按窗口建树、修改一段数据后增量更新，都与重建整棵树一致
+static int test_update(byte *data)
+{
+    const size_t leaf = 96, len = 37 * leaf + 50;
+    byte root[SHA256_HASH_SIZE], expected[SHA256_HASH_SIZE];
+    sha256_tree tree;
+    int ok = 1;
+
+    if (sha256_tree_init(&tree, len, leaf) != 0) return 0;
+    for (size_t first = 0; first < tree.leaf_count; first += 8) {
+        size_t n = (first + 8) * leaf < len ? 8 * leaf : len - first * leaf;
+        if (sha256_tree_update(&tree, first, data + first * leaf, n, 2) != 0) ok = 0;
+    }
+    sha256_tree_root(&tree, root);
+    reference_digest(data, len, leaf, expected);
+    if (memcmp(root, expected, 32) != 0) ok = 0;
+
+    // 每个叶子（含最后一个短叶子）各改一个字节，只更新该叶子
+    for (size_t i = 0; i < tree.leaf_count; i++) {
+        size_t n = i + 1 < tree.leaf_count ? leaf : len - i * leaf;
+        data[i * leaf + n / 2] ^= 0x5a;
+        if (sha256_tree_update(&tree, i, data + i * leaf, n, 1) != 0) ok = 0;
+        sha256_tree_root(&tree, root);
+        reference_digest(data, len, leaf, expected);
+        if (memcmp(root, expected, 32) != 0) {
+            printf("Tree update mismatch at leaf %zu\n", i);
+            ok = 0;
+        }
+        data[i * leaf + n / 2] ^= 0x5a;
+        sha256_tree_update(&tree, i, data + i * leaf, n, 1);
+    }
+
+    // 不是整叶子、越过末尾、起点越界、空范围
+    if (sha256_tree_update(&tree, 0, data, leaf - 1, 1) != -1) ok = 0;
+    if (sha256_tree_update(&tree, tree.leaf_count - 1, data, leaf, 1) != -1) ok = 0;
+    if (sha256_tree_update(&tree, tree.leaf_count, data, leaf, 1) != -1) ok = 0;
+    if (sha256_tree_update(&tree, 0, data, 0, 1) != -1) ok = 0;
+    sha256_tree_free(&tree);
+
+    // 叶子长度是树摘要的一部分：同一数据换叶子长度得到不同的根，也不等于整条消息的 sha256
+    sha256_tree_digest(data, len, 64, 1, root);
+    sha256_tree_digest(data, len, 128, 1, expected);
+    if (memcmp(root, expected, 32) == 0) ok = 0;
+    sha256(data, len, expected);
+    if (memcmp(root, expected, 32) == 0) ok = 0;
+    return ok;
+}
+
+int main(void)
+{
+    static byte data[TREE_MAX_LEN];
+    int ok = 1;
+    for (size_t i = 0; i < sizeof(data); i++) data[i] = (byte)(i * 31 + 7);
+
+    for (size_t i = 0; i < sizeof(SHA256_IMPLS) / sizeof(SHA256_IMPLS[0]); i++) {
+        if (sha256_select_impl(SHA256_IMPLS[i]) != 0) {
+            printf("SKIP: [%s] not supported on this CPU\n", SHA256_IMPLS[i]);
+            continue;
+        }
+        int r = test_reference(data);
+        printf("SHA-256 tree RFC 6962 reference [%s]: %s\n", SHA256_IMPLS[i], r ? "PASS" : "FAIL");
+        ok &= r;
+        r = test_update(data);
+        printf("SHA-256 tree incremental update [%s]: %s\n", SHA256_IMPLS[i], r ? "PASS" : "FAIL");
+        ok &= r;
+    }
+    sha256_select_impl(NULL);
+
+    if (!ok) {
+        printf("至少一个 SHA-256 树测试失败。\n");
+        return 1;
+    }
+    printf("所有 SHA-256 树测试通过。\n");
+    return 0;
+}
@@ -0,0 +1,228 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "AES/AESEncryption.h"
+#include "AES/AESDecryption.h"
+#include "crypto/gcm.h"
+#include "crypto/thread.h"
+#include "vectors.h"
+
+// 多线程并发测试：每个线程同时跑 CBC、ETM、GCM，并与 vectors.h 中的测试向量比对；另测分段多线程的 CBC 解密与 GCM
+// 旧实现使用全局 state[4][4]，并发时会互相破坏中间状态
+
+#define THREAD_COUNT 8
+#define ITERATIONS 200
+
+static const byte MAC_KEY[32] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+    0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f};
+
+// 64字节明文经PKCS#7填充后为80字节，再加IV与TAG
+#define ETM_OUT_LEN (ETM_OVERHEAD + sizeof(AES128_CBC_PLAINTEXT) + BLOCK_SIZE)
+
+static byte etm_expected[ETM_OUT_LEN];
+
+struct worker_arg {
+    int id;
+    int failures;
+};
+
+static int check_cbc(void)
+{
+    byte out[64], back[64];
+    encrypt_cbc((byte *)AES128_KEY, (byte *)AES128_CBC_IV, (byte *)AES128_CBC_PLAINTEXT, out, sizeof(out));
+    if (memcmp(out, AES128_CBC_CIPHERTEXT, sizeof(out)) != 0) return 1;
+    decrypt_cbc((byte *)AES128_KEY, (byte *)AES128_CBC_IV, out, back, sizeof(back));
+    return memcmp(back, AES128_CBC_PLAINTEXT, sizeof(back)) != 0;
+}
+
+static int check_etm(void)
+{
+    byte iv[ETM_IV_SIZE];
+    byte out[ETM_OUT_LEN], back[ETM_OUT_LEN];
+    memcpy(iv, AES128_CBC_IV, ETM_IV_SIZE);
+    int out_len = encrypt_etm((byte *)AES128_KEY, (byte *)MAC_KEY, iv, (byte *)AES128_CBC_PLAINTEXT,
+                              sizeof(AES128_CBC_PLAINTEXT), out);
+    if (out_len != (int)ETM_OUT_LEN || memcmp(out, etm_expected, ETM_OUT_LEN) != 0) return 1;
+    int dec_len = decrypt_etm((byte *)AES128_KEY, (byte *)MAC_KEY, out, out_len, back);
+    return dec_len != (int)sizeof(AES128_CBC_PLAINTEXT) || memcmp(back, AES128_CBC_PLAINTEXT, dec_len) != 0;
+}
+
+static int check_gcm(void)
+{
+    byte ct[sizeof(GCM_TC4_PLAINTEXT)], pt[sizeof(GCM_TC4_PLAINTEXT)], tag[GCM_TAG_SIZE];
+    aes_gcm_encrypt(GCM_TC4_KEY, GCM_TC4_IV, sizeof(GCM_TC4_IV), GCM_TC4_PLAINTEXT, sizeof(GCM_TC4_PLAINTEXT),
+                    GCM_TC4_AAD, sizeof(GCM_TC4_AAD), ct, tag);
+    if (memcmp(ct, GCM_TC4_CIPHERTEXT, sizeof(ct)) != 0 || memcmp(tag, GCM_TC4_TAG, GCM_TAG_SIZE) != 0) return 1;
+    int ret = aes_gcm_decrypt(GCM_TC4_KEY, GCM_TC4_IV, sizeof(GCM_TC4_IV), ct, sizeof(ct),
+                              GCM_TC4_AAD, sizeof(GCM_TC4_AAD), pt, tag);
+    return ret != (int)sizeof(pt) || memcmp(pt, GCM_TC4_PLAINTEXT, sizeof(pt)) != 0;
+}
+
+// 分段多线程CBC解密：各种线程数、原地与非原地，结果必须与单线程一致
+#define PARALLEL_BLOCKS (3 * 64 * 1024 + 5)
+
+static int check_cbc_parallel(void)
+{
+    const size_t len = (size_t)PARALLEL_BLOCKS * BLOCK_SIZE;
+    byte *plain = (byte *)malloc(len);
+    byte *cipher = (byte *)malloc(len);
+    byte *back = (byte *)malloc(len);
+    int failures = 0;
+    aes_key_ctx ctx;
+
+    if (plain == NULL || cipher == NULL || back == NULL) {
+        printf("Memory allocation failed\n");
+        free(plain);
+        free(cipher);
+        free(back);
+        return 1;
+    }
+    for (size_t i = 0; i < len; i++) plain[i] = (byte)(i * 7 + (i >> 9));
+    aes_key_init(&ctx, AES128_KEY);
+    aes_cbc_encrypt(&ctx, AES128_CBC_IV, plain, cipher, len);
+
+    const int thread_counts[] = { 1, 2, 3, 8 };
+    for (size_t t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]); t++) {
+        memset(back, 0, len);
+        int used = aes_cbc_decrypt_parallel(&ctx, AES128_CBC_IV, cipher, back, len, thread_counts[t]);
+        if (memcmp(back, plain, len) != 0) {
+            printf("FAIL: parallel CBC decrypt with %d threads (used %d)\n", thread_counts[t], used);
+            failures++;
+        }
+        memcpy(back, cipher, len);
+        aes_cbc_decrypt_parallel(&ctx, AES128_CBC_IV, back, back, len, thread_counts[t]);
+        if (memcmp(back, plain, len) != 0) {
+            printf("FAIL: in-place parallel CBC decrypt with %d threads\n", thread_counts[t]);
+            failures++;
+        }
+    }
+
+    aes_key_clear(&ctx);
+    free(plain);
+    free(cipher);
+    free(back);
+    if (failures == 0) printf("PASS: multi-threaded CBC decryption\n");
+    return failures;
+}
+
+// 分段多线程GCM：各种线程数，密文与标签必须与流式（串行）结果一致，并行解密原地还原、篡改被拒绝
+#define GCM_PARALLEL_LEN ((size_t)(3 * 64 * 1024 + 5) * 16 + 7)
+
+static int check_gcm_parallel(void)
+{
+    static const char *const impls[] = { "table", "clmul" };
+    byte *plain = (byte *)malloc(GCM_PARALLEL_LEN);
+    byte *ref = (byte *)malloc(GCM_PARALLEL_LEN);
+    byte *out = (byte *)malloc(GCM_PARALLEL_LEN);
+    int failures = 0;
+
+    if (plain == NULL || ref == NULL || out == NULL) {
+        printf("Memory allocation failed\n");
+        free(plain);
+        free(ref);
+        free(out);
+        return 1;
+    }
+    for (size_t i = 0; i < GCM_PARALLEL_LEN; i++) plain[i] = (byte)(i * 11 + (i >> 10));
+
+    for (size_t k = 0; k < sizeof(impls) / sizeof(impls[0]); k++) {
+        aes_gcm_ctx ctx;
+        aes_gcm_stream st;
+        byte ref_tag[GCM_TAG_SIZE], tag[GCM_TAG_SIZE];
+        if (aes_gcm_key_init_ghash(&ctx, GCM_TC4_KEY, sizeof(GCM_TC4_KEY), impls[k]) != 0) continue;
+
+        aes_gcm_stream_init(&st, &ctx, GCM_TC4_IV, sizeof(GCM_TC4_IV), 1);
+        aes_gcm_stream_aad(&st, GCM_TC4_AAD, sizeof(GCM_TC4_AAD));
+        aes_gcm_stream_update(&st, plain, ref, GCM_PARALLEL_LEN);
+        aes_gcm_stream_final(&st, ref_tag);
+
+        const int thread_counts[] = { 1, 2, 3, 8 };
+        for (size_t t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]); t++) {
+            memset(out, 0, GCM_PARALLEL_LEN);
+            aes_gcm_encrypt_parallel(&ctx, GCM_TC4_IV, sizeof(GCM_TC4_IV), plain, GCM_PARALLEL_LEN, GCM_TC4_AAD,
+                                     sizeof(GCM_TC4_AAD), out, tag, thread_counts[t]);
+            if (memcmp(out, ref, GCM_PARALLEL_LEN) != 0 || memcmp(tag, ref_tag, GCM_TAG_SIZE) != 0) {
+                printf("FAIL: parallel GCM encrypt [%s] with %d threads\n", impls[k], thread_counts[t]);
+                failures++;
+            }
+            int ret = aes_gcm_decrypt_parallel(&ctx, GCM_TC4_IV, sizeof(GCM_TC4_IV), out, GCM_PARALLEL_LEN,
+                                               GCM_TC4_AAD, sizeof(GCM_TC4_AAD), out, ref_tag, thread_counts[t]);
+            if (ret != 0 || memcmp(out, plain, GCM_PARALLEL_LEN) != 0) {
+                printf("FAIL: in-place parallel GCM decrypt [%s] with %d threads\n", impls[k], thread_counts[t]);
+                failures++;
+            }
+        }
+        memcpy(out, ref, GCM_PARALLEL_LEN);
+        out[GCM_PARALLEL_LEN / 2] ^= 1;
+        if (aes_gcm_decrypt_parallel(&ctx, GCM_TC4_IV, sizeof(GCM_TC4_IV), out, GCM_PARALLEL_LEN, GCM_TC4_AAD,
+                                     sizeof(GCM_TC4_AAD), out, ref_tag, 3) != -1) {
+            printf("FAIL: parallel GCM decrypt accepted a modified ciphertext [%s]\n", impls[k]);
+            failures++;
+        }
+        aes_gcm_key_clear(&ctx);
+    }
+
+    free(plain);
+    free(ref);
+    free(out);
+    if (failures == 0) printf("PASS: multi-threaded GCM\n");
+    return failures;
+}
+
+static void worker(void *p)
+{
+    struct worker_arg *arg = (struct worker_arg *)p;
+    for (int i = 0; i < ITERATIONS; i++) {
+        arg->failures += check_cbc();
+        arg->failures += check_etm();
+        arg->failures += check_gcm();
+    }
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    // 单线程先计算ETM参考输出，密文部分必须与SP 800-38A向量一致
+    byte iv[ETM_IV_SIZE];
+    memcpy(iv, AES128_CBC_IV, ETM_IV_SIZE);
+    encrypt_etm((byte *)AES128_KEY, (byte *)MAC_KEY, iv, (byte *)AES128_CBC_PLAINTEXT,
+                sizeof(AES128_CBC_PLAINTEXT), etm_expected);
+    if (memcmp(etm_expected + ETM_IV_SIZE, AES128_CBC_CIPHERTEXT, sizeof(AES128_CBC_CIPHERTEXT)) != 0) {
+        printf("FAIL: ETM ciphertext does not match CBC vector\n");
+        failures++;
+    }
+
+    failures += check_cbc() + check_etm() + check_gcm();
+    printf("%s: single-thread CBC/ETM/GCM vectors\n", failures ? "FAIL" : "PASS");
+
+    struct worker_arg args[THREAD_COUNT];
+    for (int i = 0; i < THREAD_COUNT; i++) {
+        args[i].id = i;
+        args[i].failures = 0;
+    }
+    if (crypto_run_parallel(worker, args, sizeof(args[0]), THREAD_COUNT) != 0) {
+        printf("WARN: some workers ran on the calling thread\n");
+    }
+
+    for (int i = 0; i < THREAD_COUNT; i++) {
+        if (args[i].failures) {
+            printf("FAIL: thread %d saw %d mismatches\n", args[i].id, args[i].failures);
+            failures += args[i].failures;
+        }
+    }
+
+    if (failures == 0)
+        printf("PASS: %d threads x %d iterations of CBC/ETM/GCM\n", THREAD_COUNT, ITERATIONS);
+
+    failures += check_cbc_parallel();
+    failures += check_gcm_parallel();
+
+    if (failures == 0)
+        printf("All thread tests passed\n");
+    else
+        printf("Some thread tests failed (failures=%d)\n", failures);
+
+    return failures != 0;
+}